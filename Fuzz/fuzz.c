@@ -0,0 +1,276 @@
+// fuzz.c ... compare every copy of the views on the same random games
+//
+// Makes up random games (genGames), has each copy's fuzzView answer the
+// same questions about every position in them, and reports the questions
+// the copies answer differently: the first few in full, then how often
+// each copy crashed or was outvoted (or tied) on an answer. Then it times
+// each copy on the positions it didn't crash on.
+//
+// Questions only some copies were asked (e.g. where a player can go
+// from a place that only some of them say he is at) are compared among
+// those. The positions are left in fuzzPositions.txt (position n on line
+// n + 1), each copy's answers in fuzzOut_<copy>.txt and whatever it said
+// when it crashed in fuzzErr_<copy>.txt.
+// Usage: ./fuzz [-s seed] [-n games] [-r reports]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define TRUE 1
+#define FALSE 0
+
+#define NUM_COPIES 4
+#define DEFAULT_GAMES 100
+#define DEFAULT_REPORTS 3            // differences reported in full
+#define POSITIONS "fuzzPositions.txt"
+#define PLAY_LENGTH 8
+
+static const char *copies[NUM_COPIES] = { "Ass2a", "View", "View_Ass2b", "Hunt" };
+
+// A file's lines, and where each position's start
+typedef struct lines {
+    char *text;
+    char **line;
+    int numLines;
+    int *first;                      // first[n]: position n's first line; first[numPositions]: numLines
+    int numPositions;
+} Lines;
+
+static Lines answers[NUM_COPIES];
+static int ran[NUM_COPIES];          // whether the copy's fuzzView ran at all
+static int numCrashes[NUM_COPIES];
+static int numDisagreements[NUM_COPIES];
+
+static void run(const char *command);
+static void readLines(const char *fileName, Lines *lines, int positions);
+static int comparePosition(int n, int report, const char *pastPlays);
+static const char *answerTo(int copy, int n, const char *question, int length);
+static int questionLength(const char *line);
+
+int main(int argc, char *argv[]) {
+    int seed = 1, numGames = DEFAULT_GAMES, numReports = DEFAULT_REPORTS;
+    int i;
+    for(i = 1; i + 1 < argc; i += 2) {
+        if(strcmp(argv[i], "-s") == 0) seed = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-n") == 0) numGames = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-r") == 0) numReports = atoi(argv[i + 1]);
+        else break;
+    }
+    if(i != argc || numGames <= 0) {
+        fprintf(stderr, "Usage: %s [-s seed] [-n games] [-r reports]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char command[256];
+    sprintf(command, "./genGames -s %d %d > %s", seed, numGames, POSITIONS);
+    run(command);
+    Lines positions;
+    readLines(POSITIONS, &positions, FALSE);
+    printf("%d positions from %d random games (seed %d)\n\n", positions.numLines, numGames, seed);
+
+    int c;
+    for(c = 0; c < NUM_COPIES; c++) {
+        sprintf(command, "./fuzzView_%s %s > fuzzOut_%s.txt 2> fuzzErr_%s.txt",
+                copies[c], POSITIONS, copies[c], copies[c]);
+        ran[c] = system(command) == 0;
+        if(!ran[c]) {
+            printf("%s: fuzzView_%s didn't run (see fuzzErr_%s.txt)\n", copies[c], copies[c], copies[c]);
+            continue;
+        }
+
+        sprintf(command, "fuzzOut_%s.txt", copies[c]);
+        readLines(command, &answers[c], TRUE);
+        assert(answers[c].numPositions == positions.numLines);
+    }
+
+    int numDifferent = 0;
+    int n;
+    for(n = 0; n < positions.numLines; n++) {
+        if(comparePosition(n, numDifferent < numReports, positions.line[n])) numDifferent++;
+    }
+
+    printf("%d of %d positions had questions answered differently\n", numDifferent, positions.numLines);
+    for(c = 0; c < NUM_COPIES; c++) {
+        if(!ran[c]) continue;
+        printf("%-11s crashed on %5d, outvoted or tied on %5d\n",
+               copies[c], numCrashes[c], numDisagreements[c]);
+    }
+
+    printf("\n");
+    fflush(stdout);
+    for(c = 0; c < NUM_COPIES; c++) {
+        if(!ran[c]) continue;
+        sprintf(command, "./fuzzView_%s -t %s 2> /dev/null", copies[c], POSITIONS);
+        run(command);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void run(const char *command) {
+    fflush(stdout);
+    if(system(command) != 0) {
+        fprintf(stderr, "%s: failed\n", command);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Reads a file and splits it into lines, and into positions at each "= n"
+// line if asked to
+static void readLines(const char *fileName, Lines *lines, int positions) {
+    FILE *f = fopen(fileName, "r");
+    if(f == NULL) {
+        perror(fileName);
+        exit(EXIT_FAILURE);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    rewind(f);
+
+    lines->text = malloc(size + 1);
+    assert(lines->text != NULL);
+    size_t numRead = fread(lines->text, 1, size, f);
+    assert(numRead == size);
+    lines->text[size] = '\0';
+    fclose(f);
+
+    int maxLines = 1;
+    long i;
+    for(i = 0; i < size; i++) maxLines += lines->text[i] == '\n';
+    lines->line = malloc(maxLines * sizeof(char *));
+    lines->first = malloc((maxLines + 1) * sizeof(int));
+    assert(lines->line != NULL && lines->first != NULL);
+
+    lines->numLines = lines->numPositions = 0;
+    char *start = lines->text;
+    while(*start != '\0') {
+        char *end = strchr(start, '\n');
+        if(end != NULL) *end = '\0';
+
+        if(positions && start[0] == '=') {
+            assert(atoi(start + 1) == lines->numPositions);
+            lines->first[lines->numPositions++] = lines->numLines;
+        } else {
+            lines->line[lines->numLines++] = start;
+        }
+
+        if(end == NULL) break;
+        start = end + 1;
+    }
+    lines->first[lines->numPositions] = lines->numLines;
+}
+
+// Compares the copies' answers about a position, printing the questions
+// answered differently if asked to report; returns whether there were any
+static int comparePosition(int n, int report, const char *pastPlays) {
+    int crashed[NUM_COPIES];
+    int odd[NUM_COPIES] = { 0 };
+    int c, d, i;
+    for(c = 0; c < NUM_COPIES; c++) {
+        crashed[c] = ran[c] && answerTo(c, n, "crashed", strlen("crashed")) != NULL;
+        numCrashes[c] += crashed[c];
+    }
+
+    int different = FALSE;
+    for(c = 0; c < NUM_COPIES; c++) {
+        if(!ran[c] || crashed[c]) continue;
+
+        Lines *mine = &answers[c];
+        for(i = mine->first[n]; i < mine->first[n + 1]; i++) {
+            const char *question = mine->line[i];
+            int length = questionLength(question);
+
+            //asked already if an earlier copy was asked it too
+            int asked = FALSE;
+            for(d = 0; d < c; d++) {
+                if(ran[d] && !crashed[d] && answerTo(d, n, question, length) != NULL) asked = TRUE;
+            }
+            if(asked) continue;
+
+            //group the copies by their answer: group[d] is the first copy answering as d did
+            const char *answer[NUM_COPIES];
+            int group[NUM_COPIES], size[NUM_COPIES] = { 0 };
+            int numGroups = 0;
+            for(d = 0; d < NUM_COPIES; d++) {
+                answer[d] = ran[d] && !crashed[d] ? answerTo(d, n, question, length) : NULL;
+                group[d] = d;
+                if(answer[d] == NULL) continue;
+                int e;
+                for(e = 0; e < d && (answer[e] == NULL || strcmp(answer[e], answer[d]) != 0); e++);
+                group[d] = e;
+                size[e]++;
+                if(e == d) numGroups++;
+            }
+            if(numGroups < 2) continue;
+
+            //the odd ones out: all but the one biggest group, if there is one
+            int biggest = 0, numBiggest = 0;
+            for(d = 0; d < NUM_COPIES; d++) {
+                if(size[d] > size[biggest]) biggest = d;
+            }
+            for(d = 0; d < NUM_COPIES; d++) numBiggest += size[d] == size[biggest];
+            for(d = 0; d < NUM_COPIES; d++) {
+                if(answer[d] != NULL && (group[d] != biggest || numBiggest > 1)) odd[d] = TRUE;
+            }
+
+            if(report) {
+                if(!different) {
+                    printf("position %d (line %d of %s, %d plays):\n", n, n + 1, POSITIONS,
+                           (int) (strlen(pastPlays) + 1) / PLAY_LENGTH);
+                    for(d = 0; d < NUM_COPIES; d++) {
+                        if(crashed[d]) printf("  %s crashed\n", copies[d]);
+                    }
+                }
+                printf("  %.*s:\n", length, question);
+                int e;
+                for(e = 0; e < NUM_COPIES; e++) {
+                    if(size[e] == 0) continue;
+                    printf("   ");
+                    for(d = 0; d < NUM_COPIES; d++) {
+                        if(answer[d] != NULL && group[d] == e) printf(" %s", copies[d]);
+                    }
+                    printf(":%s\n", answer[e]);
+                }
+            }
+            different = TRUE;
+        }
+    }
+
+    if(report && !different) {
+        for(c = 0; c < NUM_COPIES; c++) {
+            if(!crashed[c]) continue;
+            if(!different) printf("position %d (line %d of %s):\n", n, n + 1, POSITIONS);
+            printf("  %s crashed\n", copies[c]);
+            different = TRUE;
+        }
+    }
+    if(report && different) printf("\n");
+
+    for(c = 0; c < NUM_COPIES; c++) {
+        numDisagreements[c] += odd[c];
+        if(crashed[c]) different = TRUE;
+    }
+    return different;
+}
+
+// A copy's answer to a question about a position (after the ':'), or NULL
+// if it wasn't asked
+static const char *answerTo(int copy, int n, const char *question, int length) {
+    Lines *mine = &answers[copy];
+    int i;
+    for(i = mine->first[n]; i < mine->first[n + 1]; i++) {
+        const char *line = mine->line[i];
+        if(questionLength(line) == length && strncmp(line, question, length) == 0) {
+            return line[length] == ':' ? line + length + 1 : line + length;
+        }
+    }
+    return NULL;
+}
+
+// How much of an answer line is the question: up to the ':'
+static int questionLength(const char *line) {
+    const char *colon = strchr(line, ':');
+    return colon != NULL ? colon - line : strlen(line);
+}
@@ -0,0 +1,298 @@
+// fuzzView.c ... answer the fuzzer's questions with one copy of the views
+//
+// Built once for each copy (their names clash, so each gets a program of
+// its own: fuzzView_<copy>), this reads positions, one pastPlays per line.
+// For each position it prints what newGameView() makes of it, and the
+// places connectedLocations() gives each player. When Dracula is to play,
+// it also prints what newDracView() makes of it. Lists of places are
+// sorted, since nothing says what order they come in. Each answer is a
+// line of its own, "question: answer", after a line "= n" for position n.
+//
+// Each position is asked about in a child process of its own, so a copy
+// that crashes (or fails an assert) on one still answers for the rest; the
+// answer is then just "crashed: signal n". With -t it prints nothing about
+// the positions. It prints one line: how fast the views were on the ones
+// that didn't crash. A copy whose DracView doesn't build is compiled with
+// -DNO_DRAC_VIEW and only answers for its GameView.
+// Usage: ./fuzzView_<copy> [-t] positions
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "Globals.h"
+#include "Game.h"
+#include "GameView.h"
+#ifndef NO_DRAC_VIEW
+#include "DracView.h"
+#endif
+#include "Places.h"
+
+#ifndef COPY
+#define COPY "views"
+#endif
+
+#define MAX_PLAYS (NUM_PLAYERS * GAME_START_SCORE)
+#define MAX_LINE (MAX_PLAYS * 8 + 2)     // 8 chars a play, with the newline and '\0'
+#define NUM_CONNECTIONS 4            // road, rail and sea combinations asked about
+
+typedef struct timing {
+    double gameViews;                // seconds in newGameView()
+    double connections;              // seconds in connectedLocations()
+    double dracViews;                // seconds in newDracView() and its questions
+    long numConnections;
+    int numDracViews;
+} Timing;
+
+static const int connections[NUM_CONNECTIONS][3] = {
+    { TRUE, TRUE, TRUE }, { TRUE, FALSE, FALSE }, { FALSE, TRUE, FALSE }, { FALSE, FALSE, TRUE }
+};
+
+static PlayerMessage messages[MAX_PLAYS];
+static int printing;                 // FALSE when only timing
+
+static char **readPositions(char *fileName, int *numPositions);
+static int askInChild(char *pastPlays, Timing *timing, int pipeEnds[2]);
+static void askGameView(char *pastPlays, Timing *timing);
+#ifndef NO_DRAC_VIEW
+static void askDracView(char *pastPlays, Timing *timing);
+#endif
+static void printPlaces(const char *name, LocationID *places, int numPlaces);
+static void printLine(const char *format, ...);
+static double secondsSince(const struct timespec *start);
+static int compareIDs(const void *a, const void *b);
+
+int main(int argc, char *argv[]) {
+    int timed = argc == 3 && strcmp(argv[1], "-t") == 0;
+    if(argc != 2 && !timed) {
+        fprintf(stderr, "Usage: %s [-t] positions\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printing = !timed;
+
+    int numPositions;
+    char **positions = readPositions(argv[argc - 1], &numPositions);
+
+    int pipeEnds[2];
+    if(pipe(pipeEnds) != 0) {
+        perror("pipe");
+        return EXIT_FAILURE;
+    }
+
+    Timing timing = { 0 };
+    int numCrashed = 0;
+    int i;
+    for(i = 0; i < numPositions; i++) {
+        printLine("= %d\n", i);
+        if(!askInChild(positions[i], &timing, pipeEnds)) numCrashed++;
+        free(positions[i]);
+    }
+    free(positions);
+
+    if(timed) {
+        int numAnswered = numPositions - numCrashed;
+        printf("%-11s %5d positions (%4d crashed): newGameView %8.0f/s  connectedLocations %9.0f/s  ",
+               COPY, numPositions, numCrashed, numAnswered / timing.gameViews,
+               timing.numConnections / timing.connections);
+        if(timing.numDracViews > 0) {
+            printf("newDracView %8.0f/s\n", timing.numDracViews / timing.dracViews);
+        } else {
+            printf("newDracView        -\n");
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+// Asks about a position in a child process, which sends back how long it
+// took; returns FALSE if the child crashed
+static int askInChild(char *pastPlays, Timing *timing, int pipeEnds[2]) {
+    fflush(stdout);                              //or the child prints it again
+    pid_t child = fork();
+    assert(child >= 0);
+
+    if(child == 0) {
+        Timing childTiming = { 0 };
+        askGameView(pastPlays, &childTiming);
+        fflush(stdout);
+        ssize_t written = write(pipeEnds[1], &childTiming, sizeof(Timing));
+        _exit(written == sizeof(Timing) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    int status;
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        printLine("crashed: signal %d\n", WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+        return FALSE;
+    }
+
+    Timing childTiming;
+    ssize_t numRead = read(pipeEnds[0], &childTiming, sizeof(Timing));
+    assert(numRead == sizeof(Timing));
+    timing->gameViews += childTiming.gameViews;
+    timing->connections += childTiming.connections;
+    timing->dracViews += childTiming.dracViews;
+    timing->numConnections += childTiming.numConnections;
+    timing->numDracViews += childTiming.numDracViews;
+    return TRUE;
+}
+
+// Reads every line of a file
+static char **readPositions(char *fileName, int *numPositions) {
+    FILE *f = fopen(fileName, "r");
+    if(f == NULL) {
+        perror(fileName);
+        exit(EXIT_FAILURE);
+    }
+
+    int maxPositions = 1024;
+    char **positions = malloc(maxPositions * sizeof(char *));
+    assert(positions != NULL);
+    *numPositions = 0;
+
+    static char line[MAX_LINE];
+    while(fgets(line, sizeof(line), f) != NULL) {
+        line[strcspn(line, "\n")] = '\0';
+        if(*numPositions == maxPositions) {
+            maxPositions *= 2;
+            positions = realloc(positions, maxPositions * sizeof(char *));
+            assert(positions != NULL);
+        }
+        positions[(*numPositions)++] = strdup(line);
+    }
+
+    fclose(f);
+    return positions;
+}
+
+// Prints what a GameView of the position says, then where each player
+// can go from where they are
+static void askGameView(char *pastPlays, Timing *timing) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    GameView gv = newGameView(pastPlays, messages);
+    timing->gameViews += secondsSince(&start);
+
+    Round round = getRound(gv);
+    PlayerID current = getCurrentPlayer(gv);
+    printLine("view: round %d player %d score %d\n", round, current, getScore(gv));
+
+    PlayerID p;
+    for(p = 0; p < NUM_PLAYERS; p++) {
+        LocationID trail[TRAIL_SIZE];
+        getHistory(gv, p, trail);
+        printLine("player %d: health %d location %d history %d %d %d %d %d %d\n", p,
+                  getHealth(gv, p), getLocation(gv, p),
+                  trail[0], trail[1], trail[2], trail[3], trail[4], trail[5]);
+    }
+
+    for(p = 0; p < NUM_PLAYERS; p++) {
+        LocationID from = getLocation(gv, p);
+        if(!validPlace(from)) continue;
+
+        int c;
+        for(c = 0; c < NUM_CONNECTIONS; c++) {
+            int numLocations;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            LocationID *next = connectedLocations(gv, &numLocations, from, p, round,
+                                                  connections[c][0], connections[c][1], connections[c][2]);
+            timing->connections += secondsSince(&start);
+            timing->numConnections++;
+
+            char name[64];
+            sprintf(name, "connected %d from %d road %d rail %d sea %d", p, from,
+                    connections[c][0], connections[c][1], connections[c][2]);
+            printPlaces(name, next, numLocations);
+            free(next);
+        }
+    }
+
+    disposeGameView(gv);
+#ifndef NO_DRAC_VIEW
+    if(current == PLAYER_DRACULA) askDracView(pastPlays, timing);
+#endif
+}
+
+#ifndef NO_DRAC_VIEW
+// Prints what a DracView of the position says
+static void askDracView(char *pastPlays, Timing *timing) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    DracView dv = newDracView(pastPlays, messages);
+
+    //asking everything first, so that printing isn't timed
+    int health[NUM_PLAYERS];
+    LocationID where[NUM_PLAYERS], lastFrom[NUM_PLAYERS], lastTo[NUM_PLAYERS];
+    LocationID trail[NUM_PLAYERS][TRAIL_SIZE];
+    LocationID *canGo[NUM_PLAYERS + 1];
+    int numCanGo[NUM_PLAYERS + 1];
+    int numTraps = 0, numVamps = 0;
+
+    Round round = giveMeTheRound(dv);
+    int score = giveMeTheScore(dv);
+    PlayerID p;
+    for(p = 0; p < NUM_PLAYERS; p++) {
+        health[p] = howHealthyIs(dv, p);
+        where[p] = whereIs(dv, p);
+        lastMove(dv, p, &lastFrom[p], &lastTo[p]);
+        giveMeTheTrail(dv, p, trail[p]);
+    }
+    if(validPlace(where[PLAYER_DRACULA])) whatsThere(dv, where[PLAYER_DRACULA], &numTraps, &numVamps);
+    for(p = 0; p < PLAYER_DRACULA; p++) {
+        canGo[p] = whereCanTheyGo(dv, &numCanGo[p], p, TRUE, TRUE, TRUE);
+    }
+    canGo[PLAYER_DRACULA] = whereCanIgo(dv, &numCanGo[PLAYER_DRACULA], TRUE, TRUE);
+    canGo[NUM_PLAYERS] = whereCanIgo(dv, &numCanGo[NUM_PLAYERS], TRUE, FALSE);
+
+    disposeDracView(dv);
+    timing->dracViews += secondsSince(&start);
+    timing->numDracViews++;
+
+    printLine("drac view: round %d score %d traps %d vamps %d\n", round, score, numTraps, numVamps);
+    for(p = 0; p < NUM_PLAYERS; p++) {
+        printLine("drac player %d: health %d at %d last %d %d trail %d %d %d %d %d %d\n", p,
+                  health[p], where[p], lastFrom[p], lastTo[p],
+                  trail[p][0], trail[p][1], trail[p][2], trail[p][3], trail[p][4], trail[p][5]);
+    }
+    for(p = 0; p <= NUM_PLAYERS; p++) {
+        char name[64];
+        if(p < PLAYER_DRACULA) sprintf(name, "drac whereCanTheyGo %d", p);
+        else sprintf(name, "drac whereCanIgo road 1 sea %d", p == PLAYER_DRACULA);
+        printPlaces(name, canGo[p], numCanGo[p]);
+        free(canGo[p]);
+    }
+}
+#endif
+
+// Prints a list of places, sorted
+static void printPlaces(const char *name, LocationID *places, int numPlaces) {
+    if(!printing) return;
+
+    qsort(places, numPlaces, sizeof(LocationID), compareIDs);
+    printf("%s:", name);
+    int i;
+    for(i = 0; i < numPlaces; i++) printf(" %d", places[i]);
+    printf("\n");
+}
+
+static void printLine(const char *format, ...) {
+    if(!printing) return;
+
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+static double secondsSince(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int compareIDs(const void *a, const void *b) {
+    return *(const LocationID *) a - *(const LocationID *) b;
+}
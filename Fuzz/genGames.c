@@ -0,0 +1,260 @@
+// genGames.c ... make up random games for the differential fuzzer
+//
+// Plays random games by the rules. Hunters move anywhere connectedLocations()
+// lets them (resting included) and meet whatever is there. Dracula moves
+// anywhere he may, hiding, doubling back or teleporting when he has to,
+// laying a trap or a vampire in each city and losing them as his trail
+// moves on. His real moves are in the plays, as his own view gets them.
+// Hunt's GameView keeps the score and health; this keeps the traps and
+// vampires itself.
+//
+// Each game is printed as several positions, one pastPlays per line: the
+// game cut short at random plays (half of them with Dracula to play
+// next) and then the whole game.
+// Usage: ./genGames [-s seed] [-c cuts] numGames
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "Globals.h"
+#include "Game.h"
+#include "GameView.h"
+#include "Places.h"
+
+#define DEFAULT_CUTS 4               // positions printed before the whole game
+#define MAX_ENCOUNTERS 3             // traps and vampires Dracula leaves in one city
+#define VAMPIRE_ROUNDS 13            // he leaves a vampire every this many rounds
+#define MAX_PLAYS (NUM_PLAYERS * GAME_START_SCORE)
+
+// One of Dracula's moves still in his trail and what he left there
+typedef struct trailMove {
+    LocationID move;
+    LocationID where;
+    int trap;
+    int vamp;
+} TrailMove;
+
+static TrailMove trail[TRAIL_SIZE];  // the latest move first
+static int trailLength;
+static PlayerMessage messages[MAX_PLAYS];
+
+static void playGame(char *pastPlays);
+static void hunterPlay(GameView gv, PlayerID player, char *play);
+static void draculaPlay(GameView gv, char *play);
+static int draculaOptions(GameView gv, LocationID options[]);
+static int inTrail(LocationID where, int moves);
+static int encountersAt(LocationID where);
+static int randomTo(int n);
+
+int main(int argc, char *argv[]) {
+    unsigned int seed = 1;
+    int cuts = DEFAULT_CUTS;
+    int i = 1;
+    while(i + 1 < argc && argv[i][0] == '-') {
+        if(strcmp(argv[i], "-s") == 0) seed = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-c") == 0) cuts = atoi(argv[i + 1]);
+        else break;
+        i += 2;
+    }
+    if(i != argc - 1 || cuts < 0) {
+        fprintf(stderr, "Usage: %s [-s seed] [-c cuts] numGames\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int numGames = atoi(argv[i]);
+    srand(seed);
+
+    static char pastPlays[MAX_PLAYS * PLAY_LENGTH];
+    int g, c;
+    for(g = 0; g < numGames; g++) {
+        playGame(pastPlays);
+        int total = (strlen(pastPlays) + 1) / PLAY_LENGTH;
+
+        for(c = 0; c < cuts; c++) {
+            int plays = 1 + randomTo(total);
+            if(c % 2 == 0) {
+                //just before Dracula's next play
+                plays -= (plays + 1) % NUM_PLAYERS;
+                if(plays <= 0) plays = NUM_PLAYERS - 1;
+                if(plays > total) continue;
+            }
+            printf("%.*s\n", plays * PLAY_LENGTH - 1, pastPlays);
+        }
+        printf("%s\n", pastPlays);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// Plays a game until Dracula dies or the score runs out
+static void playGame(char *pastPlays) {
+    GameView gv = newGameView("", messages);
+    trailLength = 0;
+    pastPlays[0] = '\0';
+
+    char *end = pastPlays;
+    while(getScore(gv) > 0 && getHealth(gv, PLAYER_DRACULA) > 0) {
+        PlayerID player = getCurrentPlayer(gv);
+        char play[PLAY_LENGTH + 1];
+        if(player == PLAYER_DRACULA) {
+            draculaPlay(gv, play);
+        } else {
+            hunterPlay(gv, player, play);
+        }
+
+        if(end != pastPlays) *end++ = ' ';
+        memcpy(end, play, PLAY_LENGTH - 1);
+        end += PLAY_LENGTH - 1;
+        *end = '\0';
+        applyPlays(gv, play);
+    }
+
+    disposeGameView(gv);
+}
+
+// Moves a hunter somewhere he can get to, meeting the traps (oldest first),
+// then the vampire, then Dracula there until he has no health left; there
+// are never more than MAX_ENCOUNTERS traps and vampires in one city
+static void hunterPlay(GameView gv, PlayerID player, char *play) {
+    LocationID to;
+    if(getRound(gv) == 0) {
+        do {
+            to = randomTo(NUM_MAP_LOCATIONS);
+        } while(to == ST_JOSEPH_AND_ST_MARYS);
+    } else {
+        int numLocations;
+        LocationID *next = connectedLocations(gv, &numLocations, getLocation(gv, player), player,
+                                              getRound(gv), TRUE, TRUE, TRUE);
+        assert(numLocations > 0);
+        to = next[randomTo(numLocations)];
+        free(next);
+    }
+
+    sprintf(play, "%c%s....", "GSHMD"[player], idToAbbrev(to));
+    if(idToType(to) == SEA) return;
+
+    int health = getHealth(gv, player);
+    int numActions = 0;
+    int i;
+    for(i = trailLength - 1; i >= 0 && health > 0; i--) {
+        if(trail[i].where == to && trail[i].trap) {
+            play[3 + numActions++] = 'T';
+            trail[i].trap = FALSE;
+            health -= LIFE_LOSS_TRAP_ENCOUNTER;
+        }
+    }
+    for(i = 0; i < trailLength && health > 0; i++) {
+        if(trail[i].where == to && trail[i].vamp) {
+            play[3 + numActions++] = 'V';
+            trail[i].vamp = FALSE;
+        }
+    }
+    if(trailLength > 0 && trail[0].where == to && health > 0) {
+        play[3 + numActions++] = 'D';
+    }
+}
+
+// Moves Dracula, leaving a trap or vampire if he ends up in a city, and
+// says what left his trail
+static void draculaPlay(GameView gv, char *play) {
+    LocationID options[NUM_MAP_LOCATIONS + TRAIL_SIZE + 1];
+    int numOptions = draculaOptions(gv, options);
+    LocationID move = numOptions > 0 ? options[randomTo(numOptions)] : TELEPORT;
+
+    LocationID where = move;
+    if(move == TELEPORT) where = CASTLE_DRACULA;
+    else if(move == HIDE) where = trail[0].where;
+    else if(move >= DOUBLE_BACK_1 && move <= DOUBLE_BACK_5) where = trail[move - DOUBLE_BACK_1].where;
+
+    sprintf(play, "D%s....", idToAbbrev(move));
+    if(trailLength == TRAIL_SIZE) {
+        TrailMove *oldest = &trail[TRAIL_SIZE - 1];
+        if(oldest->trap) play[5] = 'M';
+        else if(oldest->vamp) play[5] = 'V';
+        trailLength--;
+    }
+    memmove(&trail[1], &trail[0], trailLength * sizeof(TrailMove));
+    trailLength++;
+
+    TrailMove *latest = &trail[0];
+    latest->move = move;
+    latest->where = where;
+    latest->trap = latest->vamp = FALSE;
+    if(idToType(where) != SEA && encountersAt(where) < MAX_ENCOUNTERS) {
+        if(getRound(gv) % VAMPIRE_ROUNDS == 0) {
+            latest->vamp = TRUE;
+            play[4] = 'V';
+        } else {
+            latest->trap = TRUE;
+            play[3] = 'T';
+        }
+    }
+}
+
+// Fills in the moves Dracula may make: any city to start with, then any
+// place he can get to by road or sea that isn't in his trail, or a HIDE
+// or DOUBLE_BACK if there isn't one in it already
+static int draculaOptions(GameView gv, LocationID options[]) {
+    int numOptions = 0;
+    LocationID i;
+
+    if(trailLength == 0) {
+        for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
+            if(idToType(i) != SEA && i != ST_JOSEPH_AND_ST_MARYS) options[numOptions++] = i;
+        }
+        return numOptions;
+    }
+
+    LocationID from = trail[0].where;
+    int numNext;
+    LocationID *next = connectedLocations(gv, &numNext, from, PLAYER_DRACULA, getRound(gv),
+                                          TRUE, FALSE, TRUE);
+    int n;
+    for(n = 0; n < numNext; n++) {
+        if(next[n] != ST_JOSEPH_AND_ST_MARYS && !inTrail(next[n], TRAIL_SIZE - 1)) {
+            options[numOptions++] = next[n];
+        }
+    }
+
+    if(!inTrail(HIDE, TRAIL_SIZE - 1) && idToType(from) != SEA) options[numOptions++] = HIDE;
+    int doubledBack = FALSE;
+    for(i = DOUBLE_BACK_1; i <= DOUBLE_BACK_5; i++) {
+        if(inTrail(i, TRAIL_SIZE - 1)) doubledBack = TRUE;
+    }
+    for(i = 0; !doubledBack && i < trailLength && i < TRAIL_SIZE - 1; i++) {
+        int reachable = trail[i].where == from;
+        for(n = 0; n < numNext; n++) {
+            if(next[n] == trail[i].where) reachable = TRUE;
+        }
+        if(reachable) options[numOptions++] = DOUBLE_BACK_1 + i;
+    }
+
+    free(next);
+    return numOptions;
+}
+
+// Whether a place or move is one of Dracula's last few moves (or where
+// one took him)
+static int inTrail(LocationID where, int moves) {
+    int i;
+    for(i = 0; i < trailLength && i < moves; i++) {
+        if(trail[i].move == where || trail[i].where == where) return TRUE;
+    }
+    return FALSE;
+}
+
+// The traps and vampires Dracula has left in a place
+static int encountersAt(LocationID where) {
+    int count = 0;
+    int i;
+    for(i = 0; i < trailLength; i++) {
+        if(trail[i].where == where) count += trail[i].trap + trail[i].vamp;
+    }
+    return count;
+}
+
+// A random number from 0 to n - 1
+static int randomTo(int n) {
+    assert(n > 0);
+    return rand() % n;
+}
@@ -0,0 +1,32 @@
+// Check.h ... how much the views check on each call
+//
+// CHECK_LEVEL (set in the Makefile) picks the tier:
+//   2  full: each call also walks the view's invariants and checks its
+//      answers (for tests)
+//   1  entry: each call checks its arguments and that the view is there
+//   0  none, for tournament builds
+// Checks made once while building a view, and checks that guard memory
+// (such as malloc() failing), stay plain asserts at every level.
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <assert.h>
+
+#ifndef CHECK_LEVEL
+#define CHECK_LEVEL 1
+#endif
+
+#if CHECK_LEVEL >= 1
+#define CHECK(cond) assert(cond)
+#else
+#define CHECK(cond) ((void) 0)
+#endif
+
+#if CHECK_LEVEL >= 2
+#define CHECK_FULL(cond) assert(cond)
+#else
+#define CHECK_FULL(cond) ((void) 0)
+#endif
+
+#endif
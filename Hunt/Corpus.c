@@ -0,0 +1,153 @@
+// Corpus.c ... read every position in a file of recorded games
+
+#define _GNU_SOURCE                 // memmem()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Globals.h"
+#include "Corpus.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define PAST_PLAYS_KEY "\"pastPlays\": \""
+
+struct corpus {
+    const char *start;              // the mapping
+    size_t size;
+    const char *next;               // where to look for the next position
+    Position last;                  // the position handed out last
+    int fedView;                    // whether *view is at 'last' (see feedGameView)
+};
+
+// *** Private functions ***
+static void validCorpus(Corpus corpus);
+
+
+// Maps a corpus file into memory
+Corpus openCorpus(const char *fileName)
+{
+    assert(fileName != NULL);
+
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0) return NULL;
+
+    struct stat info;
+    if(fstat(fd, &info) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    //an empty file can't be mapped, but is an empty corpus
+    const char *start = NULL;
+    if(info.st_size > 0) {
+        start = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(start == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+        madvise((void *) start, info.st_size, MADV_SEQUENTIAL);
+    }
+    close(fd);                      //the mapping stays
+
+    Corpus corpus = malloc(sizeof(struct corpus));
+    assert(corpus != NULL);
+    corpus->start = start;
+    corpus->size = info.st_size;
+    corpus->next = start;
+    corpus->last.plays = NULL;
+    corpus->last.length = 0;
+    corpus->last.shared = 0;
+    corpus->fedView = FALSE;
+
+    return corpus;
+}
+
+// Unmaps the corpus
+void closeCorpus(Corpus corpus)
+{
+    validCorpus(corpus);
+
+    if(corpus->size > 0) munmap((void *) corpus->start, corpus->size);
+    free(corpus);
+}
+
+// Moves on to the next position in the file
+int nextPosition(Corpus corpus, Position *position)
+{
+    validCorpus(corpus);
+    assert(position != NULL);
+
+    //an empty corpus has no mapping to search
+    if(corpus->size == 0 || corpus->next == NULL) return FALSE;
+
+    const char *end = corpus->start + corpus->size;
+    const char *plays = NULL, *quote = NULL;
+    while(quote == NULL) {
+        const char *key = memmem(corpus->next, end - corpus->next, PAST_PLAYS_KEY, strlen(PAST_PLAYS_KEY));
+        if(key == NULL) {
+            corpus->next = end;
+            return FALSE;
+        }
+
+        //a key with no closing quote on its line is not a position
+        plays = key + strlen(PAST_PLAYS_KEY);
+        const char *eol = memchr(plays, '\n', end - plays);
+        if(eol == NULL) eol = end;
+        quote = memchr(plays, '"', eol - plays);
+        corpus->next = eol;
+    }
+
+    position->plays = plays;
+    position->length = quote - plays;
+
+    //it carries on from the one before if it starts with all of it
+    //(or is the same again, as when several players log the same turn)
+    Position *last = &corpus->last;
+    position->shared = 0;
+    if(last->plays != NULL && last->length > 0 && last->length <= position->length &&
+       (last->length == position->length || position->plays[last->length] == ' ') &&
+       memcmp(position->plays, last->plays, last->length) == 0) {
+        position->shared = last->length;
+    }
+
+    corpus->last = *position;
+    corpus->fedView = FALSE;
+    return TRUE;
+}
+
+// Brings the view to the next position, building on it where it can
+int feedGameView(Corpus corpus, GameView *view)
+{
+    validCorpus(corpus);
+    assert(view != NULL);
+
+    int viewAtLast = corpus->fedView && *view != NULL;
+
+    Position position;
+    if(!nextPosition(corpus, &position)) return FALSE;
+
+    if(viewAtLast && position.shared > 0) {
+        applyPlaysLength(*view, position.plays + position.shared, position.length - position.shared);
+    } else {
+        if(*view != NULL) disposeGameView(*view);
+        *view = newGameView("", NULL);
+        applyPlaysLength(*view, position.plays, position.length);
+    }
+
+    corpus->fedView = TRUE;
+    return TRUE;
+}
+
+
+//// Private functions
+
+static void validCorpus(Corpus corpus) {
+    assert(corpus != NULL);
+    assert(corpus->next >= corpus->start && corpus->next <= corpus->start + corpus->size);
+}
@@ -0,0 +1,47 @@
+// Corpus.h ... read every position in a file of recorded games
+//
+// A corpus is a file with one position per line, each holding a
+// "pastPlays": "..." string the way the game logs in GameLog/ do. The
+// file is mapped into memory rather than read, and positions are handed
+// out as pointers into the mapping, so nothing is copied: the plays are
+// not followed by a '\0', use their length (applyPlaysLength() takes
+// them as they are).
+//
+// A log has the pastPlays of every turn of a game, so most positions are
+// the one before plus a play or two; feedGameView() takes advantage of
+// that by bringing one view forward instead of building a view for each.
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include "GameView.h"
+
+typedef struct corpus *Corpus;
+
+// openCorpus() maps a corpus file, returning NULL (with errno set) if it
+// can't; closeCorpus() unmaps it, after which no position from it is good
+Corpus openCorpus(const char *fileName);
+void closeCorpus(Corpus corpus);
+
+// A position: its plays are 'length' chars at 'plays', in the mapping.
+// 'shared' is how many of those chars are the whole of the position
+// before it (when this one carries on from it or repeats it), or 0 if
+// this one starts afresh
+typedef struct position {
+    const char *plays;
+    int length;
+    int shared;
+} Position;
+
+// nextPosition() moves on to the next position in the file, returning
+// FALSE once there are no more
+int nextPosition(Corpus corpus, Position *position);
+
+// feedGameView() moves on to the next position and brings *view up to
+// it: only the new plays are applied when it carries on from the last
+// position fed, otherwise *view is disposed of and a new view made.
+// *view starts as NULL. Returns FALSE (leaving *view as it was) once
+// there are no more positions.
+int feedGameView(Corpus corpus, GameView *view);
+
+#endif
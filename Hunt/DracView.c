@@ -6,9 +6,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include <string.h>
 #include <assert.h>
 #include "Globals.h"
+#include "Check.h"
 #include "Game.h"
 #include "GameView.h"
 #include "Map.h"
@@ -30,187 +33,102 @@ struct MapRep {
    int   nV;         // #vertices
    int   nE;         // #edges
    VList connections[NUM_MAP_LOCATIONS]; // array of lists
+   atomic_int refs;  // #holders sharing it
 };
    
+// sets[t][k][p]: where a hunter can reach t from within k rounds,
+// if his first move has rail phase p (see threatSet()); it only
+// depends on the map, so it is built once (the first time a view needs
+// it) and every view reads the same one
+typedef struct threatIndex {
+    LocationSet sets[NUM_MAP_LOCATIONS][MAX_THREAT_ROUNDS + 1][NUM_RAIL_PHASES];
+} ThreatIndex;
+
+static ThreatIndex sharedThreats;
+static pthread_once_t threatsBuilt = PTHREAD_ONCE_INIT;
+
 struct dracView {
     GameView gameView;            // The game view
-    
-    int *numIV;                   // Number of immature vampire [0..1] at specific location [0..70]
-    int *numTrap;                 // Number of traps [0..3] at specific location [0..70]
-    LocationID **trail_perPlayer; // stores trail for each player in 2D array 
+    const ThreatIndex *threats;   // precomputed threat sets (sharedThreats)
 };
     
 //Private Functions
-static PlayerID whichPlayer(char c);
 static void validDracView(DracView dracView);
-static void frontInsert(LocationID **trail_perPlayer, PlayerID player, char *location);
 static void removeLocation(int *numLocations, LocationID *connLoc, LocationID v, int pos);
+static void buildThreatIndex(void);
 
 // Creates a new DracView to summarise the current state of the game
 DracView newDracView(char *pastPlays, PlayerMessage messages[])
 {
     assert(pastPlays != NULL);
-    assert(messages != NULL);
 
     //Initialise the DracView ADT
     DracView dracView = malloc(sizeof(struct dracView));
     assert(dracView != NULL);
     dracView->gameView = newGameView(pastPlays, messages);
     assert(dracView->gameView != NULL); 
-    dracView->numTrap = malloc(NUM_MAP_LOCATIONS * sizeof(int));
-    assert(dracView->numTrap != NULL);
-    dracView->numIV = malloc(NUM_MAP_LOCATIONS * sizeof(int));
-    assert(dracView->numIV != NULL);
-    dracView->trail_perPlayer = malloc(NUM_PLAYERS * sizeof(LocationID *));
-    assert(dracView->trail_perPlayer != NULL); 
-
-    int i, j = 0; 
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        dracView->numTrap[i] = 0;
-        dracView->numIV[i] = 0;
-    }
 
-    for(i = 0; i < NUM_PLAYERS; i++) {
-        dracView->trail_perPlayer[i] = malloc(GAME_START_SCORE * sizeof(LocationID));
-        assert(dracView->trail_perPlayer[i] != NULL);
- 
-        for(j = 0; j < GAME_START_SCORE; j++){
-            dracView->trail_perPlayer[i][j] = UNKNOWN_LOCATION;
-        }
-    }
+    pthread_once(&threatsBuilt, buildThreatIndex);
+    dracView->threats = &sharedThreats;
 
-    // Obtain useful data form pastPlays string
-    int interval = 8;
-    for(i = 0; i < strlen(pastPlays); i += interval) {
-        PlayerID player = whichPlayer(pastPlays[i]);  // find out which player
-
-        char *location = malloc(4 * sizeof(char));    // get the abbrev of locations
-        assert(location != NULL);
-        for(j = 0; j < 4; j++) location[j] = 0;
-        location[0] = pastPlays[i+1];
-        location[1] = pastPlays[i+2];
-
-        frontInsert(dracView->trail_perPlayer, player, location); // update the trail_perPlayer
-        free(location);
-
-        //player = one of the hunters
-        if(player != PLAYER_DRACULA) {
-            for(j = i + 3; j < i + interval - 1; j++) {
-
-                if(pastPlays[j] == '.') break;  // No more encounters this turn           
-
-                // Trigger the trap(s)
-                LocationID currLoc = dracView->trail_perPlayer[player][0];
-                assert(currLoc >= MIN_MAP_LOCATION && currLoc <= MAX_MAP_LOCATION);
-
-                if(pastPlays[j] == 'T') {
-
-                    // Disarm the trap and lose HP
-                    assert(dracView->numTrap[currLoc] > 0);
-                    assert(idToType(currLoc) != SEA);
-                    dracView->numTrap[currLoc] -= 1;
-                } else if(pastPlays[j] == 'V') {
- 
-                    // Discover an immature vampire and kill it
-                    assert(idToType(currLoc) != SEA);
-                    assert(dracView->numIV[currLoc] == 1);
-                    dracView->numIV[currLoc] -= 1;
-                } else if(pastPlays[j] == 'D') {
-
-                    // Confront Dracula
-                    assert(idToType(currLoc) != SEA);
-                }
-            }
+    return dracView;
+}
+     
+     
+// Updates the DracView with plays made since it was created or last updated
+void updateDracView(DracView currentView, const char *newPlays)
+{
+    validDracView(currentView);
+    assert(newPlays != NULL);
+
+    applyPlays(currentView->gameView, newPlays);
+}
 
-        } else {
 
-            // player = Dracula     
-            // Make sure all the locations in Dracula trail are precise location (i.e: 0..70)   
-            int pos = 0;
-            if(dracView->trail_perPlayer[player][0] == HIDE) {
-                pos = 1;
-                if(dracView->trail_perPlayer[player][1] >= DOUBLE_BACK_1 && dracView->trail_perPlayer[player][1] <= DOUBLE_BACK_5) {
-                    pos += dracView->trail_perPlayer[player][1] - DOUBLE_BACK_1 + 1;
-                }
+// Copies the DracView cheaply, to try out plays on
+DracView cloneDracView(DracView original)
+{
+    validDracView(original);
 
-                if(dracView->trail_perPlayer[player][pos] == TELEPORT) {
-                    dracView->trail_perPlayer[player][0] = CASTLE_DRACULA;
-                } else {
-                    assert(dracView->trail_perPlayer[player][pos] >= MIN_MAP_LOCATION && dracView->trail_perPlayer[player][pos] <= MAX_MAP_LOCATION);
-                    assert(idToType(dracView->trail_perPlayer[player][pos]) != SEA);
-                    dracView->trail_perPlayer[player][0] = dracView->trail_perPlayer[player][pos];
-                }
-            } else if(dracView->trail_perPlayer[player][0] >= DOUBLE_BACK_1 && dracView->trail_perPlayer[player][0] <= DOUBLE_BACK_5) {
-                pos = dracView->trail_perPlayer[player][0] - DOUBLE_BACK_1 + 1;
-                if(dracView->trail_perPlayer[player][pos] == HIDE) pos++;
-                
-                if(dracView->trail_perPlayer[player][pos] == TELEPORT) {
-                    dracView->trail_perPlayer[player][0] = CASTLE_DRACULA;
-                } else {
-                    assert(dracView->trail_perPlayer[player][pos] >= MIN_MAP_LOCATION && dracView->trail_perPlayer[player][pos] <= MAX_MAP_LOCATION);
-                    dracView->trail_perPlayer[player][0] = dracView->trail_perPlayer[player][pos];
-                }
-            } else if(dracView->trail_perPlayer[player][0] == TELEPORT) {
-                dracView->trail_perPlayer[player][0] = CASTLE_DRACULA;
-            }
-               
-            LocationID currLoc = dracView->trail_perPlayer[player][0];
-            assert(currLoc >= MIN_MAP_LOCATION && currLoc <= MAX_MAP_LOCATION);
-
-            if(pastPlays[i+5] == 'M') {
-                // The Trap malfunctions
-                LocationID leaveTrail = dracView->trail_perPlayer[player][6];
-                assert(leaveTrail >= MIN_MAP_LOCATION && leaveTrail <= MAX_MAP_LOCATION);
-                assert(idToType(leaveTrail) != SEA);
-                assert(dracView->numTrap[leaveTrail] > 0);
-                dracView->numTrap[leaveTrail] -= 1;
-            }
+    DracView clone = malloc(sizeof(struct dracView));
+    assert(clone != NULL);
+    clone->gameView = cloneGameView(original->gameView);
+    clone->threats = original->threats;
 
-            if(pastPlays[i+3] == 'T') {
-                // Place a trap
-                assert(idToType(currLoc) != SEA);       //it is impossible for Dracula to place encounter(s) when he is at the sea
-                assert(dracView->numTrap[currLoc] < 3);
-                dracView->numTrap[currLoc] += 1;
-            } 
-
-            if(pastPlays[i+4] == 'V') {
-                //places an immature vampire
-                assert(idToType(currLoc) != SEA);
-                assert(dracView->numIV[currLoc] == 0);
-                dracView->numIV[currLoc] = 1;
-            }
+    return clone;
+}
 
-            if(pastPlays[i+5] == 'V') {
-                //An immature vampire ---> wakes up and become mature vampire 
-                LocationID whereIV = dracView->trail_perPlayer[player][6];
-                assert(whereIV >= MIN_MAP_LOCATION && whereIV <= MAX_MAP_LOCATION);
-                assert(idToType(whereIV) != SEA);
-                assert(dracView->numIV[whereIV] == 1);
-                dracView->numIV[whereIV] = 0;
-            }
-        } 
 
-    }
+// Lays the DracView out flat
+void takeDracSnapshot(DracView currentView, Snapshot *snapshot)
+{
+    validDracView(currentView);
+    takeSnapshot(currentView->gameView, snapshot);
+}
+
+
+// Makes a DracView from a snapshot, or NULL if it isn't one
+DracView restoreDracView(const Snapshot *snapshot)
+{
+    GameView gameView = restoreGameView(snapshot);
+    if(gameView == NULL) return NULL;
+
+    DracView dracView = malloc(sizeof(struct dracView));
+    assert(dracView != NULL);
+    dracView->gameView = gameView;
+    pthread_once(&threatsBuilt, buildThreatIndex);
+    dracView->threats = &sharedThreats;
 
     return dracView;
 }
-     
-     
+
+
 // Frees all memory previously allocated for the DracView toBeDeleted
 void disposeDracView(DracView toBeDeleted)
 {
     validDracView(toBeDeleted);
 
-    int i;
-    for(i = 0; i < NUM_PLAYERS; i++) {
-        assert(toBeDeleted->trail_perPlayer[i] != NULL);
-        free(toBeDeleted->trail_perPlayer[i]);
-    }
-
     disposeGameView(toBeDeleted->gameView);
-    free(toBeDeleted->trail_perPlayer); 
-    free(toBeDeleted->numTrap);
-    free(toBeDeleted->numIV);
     free(toBeDeleted);
 }
 
@@ -235,7 +153,7 @@ int giveMeTheScore(DracView currentView)
 int howHealthyIs(DracView currentView, PlayerID player)
 {
     validDracView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
     return getHealth(currentView->gameView, player);
 }
 
@@ -243,12 +161,14 @@ int howHealthyIs(DracView currentView, PlayerID player)
 LocationID whereIs(DracView currentView, PlayerID player)
 {
     validDracView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
   
     // Make sure the returned location is a precise location
     if(player != PLAYER_DRACULA) return getLocation(currentView->gameView, player);
 
-    return currentView->trail_perPlayer[player][0];
+    LocationID trail[TRAIL_SIZE];
+    getLocationHistory(currentView->gameView, player, trail);
+    return trail[0];
 }
 
 // Get the most recent move of a given player
@@ -256,10 +176,13 @@ void lastMove(DracView currentView, PlayerID player,
                  LocationID *start, LocationID *end)
 {
     validDracView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
-    assert(start != NULL && end != NULL);
-    *start = currentView->trail_perPlayer[player][1];
-    *end = currentView->trail_perPlayer[player][0]; 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(start != NULL && end != NULL);
+
+    LocationID trail[TRAIL_SIZE];
+    getLocationHistory(currentView->gameView, player, trail);
+    *start = trail[1];
+    *end = trail[0]; 
 }
 
 // Find out what minions are placed at the specified location
@@ -267,9 +190,8 @@ void whatsThere(DracView currentView, LocationID where,
                          int *numTraps, int *numVamps)
 {
     validDracView(currentView);
-    assert(where >= MIN_MAP_LOCATION && where <= MAX_MAP_LOCATION);
-    *numTraps = currentView->numTrap[where];
-    *numVamps = currentView->numIV[where];
+    CHECK(where >= MIN_MAP_LOCATION && where <= MAX_MAP_LOCATION);
+    getMinions(currentView->gameView, where, numTraps, numVamps);
 }
 
 //// Functions that return information about the history of the game
@@ -279,14 +201,14 @@ void giveMeTheTrail(DracView currentView, PlayerID player,
                             LocationID trail[TRAIL_SIZE])
 {
     validDracView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
-    assert(trail != NULL);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(trail != NULL);
+
+    getLocationHistory(currentView->gameView, player, trail);
 
     int i;
-    for(i = TRAIL_SIZE - 1; i >= 0; i--) {
-        LocationID loc = currentView->trail_perPlayer[player][i];
-        assert((loc >= MIN_MAP_LOCATION && loc <= MAX_MAP_LOCATION) || loc == UNKNOWN_LOCATION);
-        trail[i] = currentView->trail_perPlayer[player][i];
+    for(i = 0; i < TRAIL_SIZE; i++) {
+        CHECK_FULL((trail[i] >= MIN_MAP_LOCATION && trail[i] <= MAX_MAP_LOCATION) || trail[i] == UNKNOWN_LOCATION);
     }
 }
 
@@ -296,21 +218,47 @@ void giveMeTheTrail(DracView currentView, PlayerID player,
 // ** Similar to the function giveMeTheTrail, but this function won't 
 //    return precise locations
 void giveMeTheMoves(DracView currentView, PlayerID player, LocationID trail[TRAIL_SIZE]) {
-    assert(currentView != NULL);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
-    assert(trail != NULL);
+    CHECK(currentView != NULL);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(trail != NULL);
 
     getHistory(currentView->gameView, player, trail);
 }
 
 
+// Points at everywhere the player has been, oldest first (no copy)
+const LocationID *giveMeTheWholeTrail(DracView currentView, PlayerID player, int *numMoves)
+{
+    validDracView(currentView);
+    return getLocations(currentView->gameView, player, numMoves);
+}
+
+// The message left with a play (no copy)
+const char *giveMeTheMessage(DracView currentView, int play)
+{
+    validDracView(currentView);
+    return getMessage(currentView->gameView, play);
+}
+
+// Everything about the present in one go (see giveMeTheState in DracView.h)
+void giveMeTheState(DracView currentView, ViewState *state)
+{
+    validDracView(currentView);
+    CHECK(state != NULL);
+    getViewState(currentView->gameView, state);
+
+    // whereIs() and giveMeTheTrail() give Dracula's precise locations
+    state->location[PLAYER_DRACULA] = state->trail[PLAYER_DRACULA][0];
+}
+
+
 //// Functions that query the map to find information about connectivity
 
 // What are my (Dracula's) possible next moves (locations)
 LocationID *whereCanIgo(DracView currentView, int *numLocations, int road, int sea)
 {
     validDracView(currentView);
-    assert(numLocations != NULL);	// check that there are locations to visit
+    CHECK(numLocations != NULL);	// check that there are locations to visit
 
     LocationID here = whereIs(currentView, PLAYER_DRACULA);
 
@@ -345,7 +293,7 @@ LocationID *whereCanIgo(DracView currentView, int *numLocations, int road, int s
         counterA++;
     }
 
-    assert(*numLocations >= 1);
+    CHECK_FULL(*numLocations >= 1);
     free(dracTrail);
     return connLoc;
 }
@@ -355,15 +303,15 @@ LocationID *whereCanTheyGo(DracView currentView, int *numLocations,
                            PlayerID player, int road, int rail, int sea)
 {
     validDracView(currentView);
-    assert(numLocations != NULL);	// check that there are locations to visit
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(numLocations != NULL);	// check that there are locations to visit
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
 
     // Use whereCanIgo if the player is Dracula
     if(player == PLAYER_DRACULA) return whereCanIgo(currentView, numLocations, road, sea);
 
     // need to find out the current location of the player (hunter)
     LocationID there = whereIs(currentView, player);
-    assert(there >= MIN_MAP_LOCATION && there <= MAX_MAP_LOCATION);
+    CHECK_FULL(there >= MIN_MAP_LOCATION && there <= MAX_MAP_LOCATION);
 
     // need to find out the current round
     Round round = giveMeTheRound(currentView);
@@ -379,15 +327,15 @@ LocationID *whereHuntersCanGoNext(DracView currentView, int *numLocations,
                            PlayerID player, int road, int rail, int sea)
 {
     validDracView(currentView);
-    assert(numLocations != NULL);	// check that there are locations to visit
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_MINA_HARKER); 
+    CHECK(numLocations != NULL);	// check that there are locations to visit
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_MINA_HARKER); 
 
     // Use whereCanIgo if the player is Dracula
     if(player == PLAYER_DRACULA) return whereCanIgo(currentView, numLocations, road, sea);
 
     // need to find out the current location of the player (hunter)
     LocationID there = whereIs(currentView, player);
-    assert(there >= MIN_MAP_LOCATION && there <= MAX_MAP_LOCATION);
+    CHECK_FULL(there >= MIN_MAP_LOCATION && there <= MAX_MAP_LOCATION);
 
     // need to find out the current round
     Round nextRound = giveMeTheRound(currentView) + 1;
@@ -397,10 +345,45 @@ LocationID *whereHuntersCanGoNext(DracView currentView, int *numLocations,
     return connectedLocations(currentView->gameView, numLocations, there, player, nextRound, road, rail, sea);
 }
 
+// Where can a hunter reach the given location from within the given number of rounds
+LocationSet threatSet(DracView currentView, LocationID where, int rounds, int railPhase)
+{
+    validDracView(currentView);
+    CHECK(where >= MIN_MAP_LOCATION && where <= MAX_MAP_LOCATION);
+    CHECK(rounds >= 0 && rounds <= MAX_THREAT_ROUNDS);
+    CHECK(railPhase >= 0 && railPhase < NUM_RAIL_PHASES);
+
+    return currentView->threats->sets[where][rounds][railPhase];
+}
+
+// Which hunters can reach the given location within the given number of rounds
+int huntersThreatening(DracView currentView, LocationID where, int rounds)
+{
+    validDracView(currentView);
+    CHECK(where >= MIN_MAP_LOCATION && where <= MAX_MAP_LOCATION);
+    CHECK(rounds >= 0 && rounds <= MAX_THREAT_ROUNDS);
+
+    // Hunters move next in the following round, each with his own rail phase
+    Round nextRound = giveMeTheRound(currentView) + 1;
+    const LocationSet (*threats)[NUM_RAIL_PHASES] = currentView->threats->sets[where];
+
+    int hunter, threatening = 0;
+    for(hunter = PLAYER_LORD_GODALMING; hunter <= PLAYER_MINA_HARKER; hunter++) {
+        LocationID there = whereIs(currentView, hunter);
+        if(there < MIN_MAP_LOCATION || there > MAX_MAP_LOCATION) continue;
+
+        if(inSet(threats[rounds][(nextRound + hunter) % NUM_RAIL_PHASES], there)) {
+            threatening |= 1 << hunter;
+        }
+    }
+
+    return threatening;
+}
+
 // Find out all the adjacent locations connected to Draculas current location
 LocationID *adjacentLocations(DracView currentView, int *numLocations) {
     validDracView(currentView);
-    assert(numLocations != NULL);
+    CHECK(numLocations != NULL);
 
     Round round = giveMeTheRound(currentView);
     LocationID loc = whereIs(currentView, PLAYER_DRACULA);
@@ -413,7 +396,7 @@ LocationID *shortestPath(DracView currentView, int *length, LocationID start, Lo
                          int road, int sea)
 {
     validDracView(currentView);
-    assert(length != NULL);
+    CHECK(length != NULL);
 
     if(start < MIN_MAP_LOCATION || start > MAX_MAP_LOCATION) {
         *length = 0;
@@ -440,17 +423,14 @@ LocationID *shortestPath(DracView currentView, int *length, LocationID start, Lo
     giveMeTheMoves(currentView, PLAYER_DRACULA, dracMoves);
    
     
-    int maxCost = 99999999;
     int dist[NUM_MAP_LOCATIONS];
     int pred[NUM_MAP_LOCATIONS];
-    int visited[NUM_MAP_LOCATIONS];
 
     int forbidden[NUM_MAP_LOCATIONS];
 
     for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        dist[i] = maxCost;
+        dist[i] = NO_PATH;
         pred[i] = UNKNOWN_LOCATION;
-        visited[i] = 0;
      
         forbidden[i] = 0;
     }
@@ -471,40 +451,29 @@ LocationID *shortestPath(DracView currentView, int *length, LocationID start, Lo
     
 
 
-    Queue q = newQueue();
-    assert(q != NULL);
+    LocationID storage[QUEUE_WORDS(NUM_MAP_LOCATIONS)];
+    Queue q = queueIn(storage, NUM_MAP_LOCATIONS);
     enterQueue(q, start);
 
+    Round round = giveMeTheRound(currentView);
+
     while(!emptyQueue(q)) {
         LocationID loc = leaveQueue(q);
+        if(loc == end) break;
 
-        if(visited[loc]) continue;
-
-        visited[loc] = 1;
-
-        int cost = 1;
-        int numLocations = 0;
-        LocationID *connLoc = connectedLocations(currentView->gameView, &numLocations, loc,
-                                                 PLAYER_DRACULA, giveMeTheRound(currentView),
-                                                 road, 0, sea);
+        int reachable[NUM_MAP_LOCATIONS];
+        reachableFrom(currentView->gameView, reachable, loc, PLAYER_DRACULA, round, road, 0, sea);
 
-        assert(connLoc != NULL);
+        LocationID v;
+        for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+            if(!reachable[v] || forbidden[v] || dist[v] != NO_PATH) continue;
 
-        for(i = 0; i < numLocations; i++) {
-            if(forbidden[connLoc[i]]) continue;
-            if(!visited[connLoc[i]]) enterQueue(q, connLoc[i]);
-       
-            if(dist[loc] + cost < dist[connLoc[i]]) { 
-                dist[connLoc[i]] = dist[loc] + cost;         
-                pred[connLoc[i]] = loc;
-            }
+            dist[v] = dist[loc] + 1;
+            pred[v] = loc;
+            enterQueue(q, v);
         }
-        
-        free(connLoc);
     }
 
-    disposeQueue(q);
-
     
     if(pred[end] == UNKNOWN_LOCATION) {
         *length = 0;
@@ -537,7 +506,7 @@ LocationID *sPathForHunters(DracView currentView, int *length, PlayerID player,
                          int road, int rail, int sea) 
 {
     validDracView(currentView);
-    assert(length != NULL);
+    CHECK(length != NULL);
 
     if(start < MIN_MAP_LOCATION || start > MAX_MAP_LOCATION) {
         *length = 0;
@@ -558,65 +527,41 @@ LocationID *sPathForHunters(DracView currentView, int *length, PlayerID player,
     }
    
     int i = 0;
-    int cost = 1;
-    int maxCost = 99999999;
     int dist[NUM_MAP_LOCATIONS], pred[NUM_MAP_LOCATIONS];
-    int visited[NUM_MAP_LOCATIONS];
 
     for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        dist[i] = maxCost;
+        dist[i] = NO_PATH;
         pred[i] = UNKNOWN_LOCATION;
-        visited[i] = 0;
     }
     dist[start] = 0;
     pred[start] = start;
 
 
-    Queue *qList = malloc(NUM_MAP_LOCATIONS * sizeof(Queue));
-    assert(qList != NULL);
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        qList[i] = newQueue();
-        assert(qList[i] != NULL);
-    }
-    enterQueue(qList[0], start);
+    LocationID storage[QUEUE_WORDS(NUM_MAP_LOCATIONS)];
+    Queue q = queueIn(storage, NUM_MAP_LOCATIONS);
+    enterQueue(q, start);
 
 
     Round nextRound = giveMeTheRound(currentView) + 1;
 
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        while(!emptyQueue(qList[i])) {
-            LocationID s = leaveQueue(qList[i]);
-
-            if(visited[s]) continue;
-            visited[s] = 1;
-
-            int numLocations = 0;
-            LocationID *connLoc = connectedLocations(currentView->gameView, &numLocations,
-                                                    s, player, nextRound + i, road, rail, sea);
-            assert(connLoc != NULL);
-             
-            int j = 0;
-            for(j = 0; j < numLocations; j++) {
-                if(i + 1 < NUM_MAP_LOCATIONS) {
-                    enterQueue(qList[i+1], connLoc[j]);
-                }
- 
-                if(dist[s] + cost < dist[connLoc[j]]) {
-                    dist[connLoc[j]] = dist[s] + cost;
-                    pred[connLoc[j]] = s;
-                }
-            }
+    while(!emptyQueue(q)) {
+        LocationID s = leaveQueue(q);
+        if(s == end) break;
+
+        // the rail allowance depends on the round this move is made in
+        int reachable[NUM_MAP_LOCATIONS];
+        reachableFrom(currentView->gameView, reachable, s, player, nextRound + dist[s], road, rail, sea);
+
+        LocationID v;
+        for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+            if(!reachable[v] || dist[v] != NO_PATH) continue;
 
-            free(connLoc);
+            dist[v] = dist[s] + 1;
+            pred[v] = s;
+            enterQueue(q, v);
         }
     }    
 
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        assert(qList[i] != NULL);
-        disposeQueue(qList[i]);
-    }
-    free(qList);
-
     if(pred[end] == UNKNOWN_LOCATION) {
         *length = 0;
         return NULL;
@@ -648,88 +593,16 @@ LocationID *sPathForHunters(DracView currentView, int *length, PlayerID player,
 
 //check whether the given dracView is valid
 static void validDracView(DracView dracView) {
-    assert(dracView != NULL);
-    assert(dracView->gameView != NULL);
-    assert(dracView->numTrap != NULL);
-    assert(dracView->numIV != NULL);
-    assert(dracView->trail_perPlayer != NULL);
-
-    int i;
-    for(i = 0; i < NUM_PLAYERS; i++) assert(dracView->trail_perPlayer[i] != NULL);
-}
-
-// Returns Id of current player
-static PlayerID whichPlayer(char c) {
-    PlayerID id;   
-
-    switch(c) {
-    case 'G': id = PLAYER_LORD_GODALMING; break;
-    case 'S': id = PLAYER_DR_SEWARD; break;
-    case 'H': id = PLAYER_VAN_HELSING; break;
-    case 'M': id = PLAYER_MINA_HARKER; break;
-    case 'D': id = PLAYER_DRACULA; break;
-    default: id = -1; break;
-    }
-
-    assert(id >= PLAYER_LORD_GODALMING && id <= PLAYER_DRACULA);
-    return id;
-}
-
-// Inserts previous location to trail accordingly 
-static void frontInsert(LocationID **trail_perPlayer, PlayerID player, char *location) {
-
-    assert(trail_perPlayer != NULL);
-    assert(trail_perPlayer[player] != NULL);
-    assert(location != NULL);    
-
-    char *db[5] = {"D1", "D2", "D3", "D4", "D5"};
-   
-    LocationID id = UNKNOWN_LOCATION;
-   
-    if(strcmp(location, "C?") == 0) {
-        id = CITY_UNKNOWN;
-    } else if(strcmp(location, "S?") == 0) {
-        id = SEA_UNKNOWN;
-    } else if(strcmp(location, "HI") == 0) {
-        id = HIDE;
-    } else if(strcmp(location, "TP") == 0) {
-        id = TELEPORT;
-    } else {
-       int i;
-       for(i = 1; i <= 5; i++) {
-           if(strcmp(location, db[i-1]) == 0) break;
-       }
-
-       if(i == 1) {
-           id = DOUBLE_BACK_1;
-       } else if(i == 2) {
-           id = DOUBLE_BACK_2;
-       } else if(i == 3) {
-           id = DOUBLE_BACK_3;
-       } else if(i == 4) {
-           id = DOUBLE_BACK_4;
-       } else if(i == 5) {
-           id = DOUBLE_BACK_5;
-       } else {
-           id = abbrevToID(location);
-       }
-    }
-
-    assert((id >= UNKNOWN_LOCATION && id <= MAX_MAP_LOCATION) || (id >= CITY_UNKNOWN && id <= TELEPORT));
-
-    int j;
-    for(j = GAME_START_SCORE - 1; j > 0; j--) {
-        trail_perPlayer[player][j] = trail_perPlayer[player][j-1];
-    }
-
-    trail_perPlayer[player][j] = id;
+    CHECK(dracView != NULL);
+    CHECK_FULL(dracView->gameView != NULL);
+    CHECK_FULL(dracView->threats == &sharedThreats);
 }
 
 // Remove the location from the connLoc array
 static void removeLocation(int *numLocations, LocationID *connLoc, LocationID v, int pos){
-    assert(numLocations != NULL);
-    assert(connLoc != NULL);
-    assert(pos >= 0 && pos < *numLocations);
+    CHECK_FULL(numLocations != NULL);
+    CHECK_FULL(connLoc != NULL);
+    CHECK_FULL(pos >= 0 && pos < *numLocations);
 
     int i;
     for(i = pos; i < *numLocations - 1; i++) {
@@ -739,4 +612,53 @@ static void removeLocation(int *numLocations, LocationID *connLoc, LocationID v,
     *numLocations = *numLocations - 1;
 }
 
+// Precomputes threats[t][k][p] for every location t, k <= MAX_THREAT_ROUNDS
+// and rail phase p; connections can be travelled both ways, so the places a
+// hunter can reach t from in k rounds are the places he can get to from
+// those he can reach t from in k - 1 rounds (one phase later); run once,
+// through pthread_once(), so views on other threads wait for it
+static void buildThreatIndex(void) {
+    // any view will do: only its map is used
+    PlayerMessage messages[1];
+    GameView gameView = newGameView("", messages);
+    assert(gameView != NULL);
+
+    // oneMove[v][p]: where a hunter at v can be after one move in phase p
+    LocationSet oneMove[NUM_MAP_LOCATIONS][NUM_RAIL_PHASES];
+    int reachable[NUM_MAP_LOCATIONS];
+
+    LocationID v, u;
+    int p, k;
+    for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+        for(p = 0; p < NUM_RAIL_PHASES; p++) {
+            reachableFrom(gameView, reachable, v, PLAYER_LORD_GODALMING, p, 1, 1, 1);
+
+            emptySet(oneMove[v][p]);
+            for(u = MIN_MAP_LOCATION; u <= MAX_MAP_LOCATION; u++) {
+                if(reachable[u]) addToSet(oneMove[v][p], u);
+            }
+        }
+    }
+
+    for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+        LocationSet (*threats)[NUM_RAIL_PHASES] = sharedThreats.sets[v];
+
+        for(p = 0; p < NUM_RAIL_PHASES; p++) {
+            emptySet(threats[0][p]);
+            addToSet(threats[0][p], v);
+        }
 
+        for(k = 1; k <= MAX_THREAT_ROUNDS; k++) {
+            for(p = 0; p < NUM_RAIL_PHASES; p++) {
+                LocationSet later = threats[k-1][(p + 1) % NUM_RAIL_PHASES];
+
+                emptySet(threats[k][p]);
+                for(u = MIN_MAP_LOCATION; u <= MAX_MAP_LOCATION; u++) {
+                    if(inSet(later, u)) unionSet(threats[k][p], oneMove[u][p]);
+                }
+            }
+        }
+    }
+
+    disposeGameView(gameView);
+}
@@ -31,10 +31,32 @@ typedef struct dracView *DracView;
 //
 // The "PlayerMessage" type is defined in Game.h.
 // You are free to ignore messages if you wish.
+//
+// The messages are not copied (see newGameView()): pass NULL to skip them.
 
 DracView newDracView(char *pastPlays, PlayerMessage messages[]);
 
 
+// updateDracView() brings the DracView up to date with plays made since it
+// was created (or last updated), in the same format as pastPlays
+
+void updateDracView(DracView currentView, const char *newPlays);
+
+
+// cloneDracView() copies the DracView (cheaply: see cloneGameView())
+// so that plays can be tried out on the copy
+
+DracView cloneDracView(DracView original);
+
+
+// takeDracSnapshot() and restoreDracView() store and bring back a DracView
+// the way takeSnapshot() and restoreGameView() do a GameView
+// (the threat index only depends on the map, so it is rebuilt, not stored)
+
+void takeDracSnapshot(DracView currentView, Snapshot *snapshot);
+DracView restoreDracView(const Snapshot *snapshot);
+
+
 // disposeDracView() frees all memory previously allocated for the DracView
 // toBeDeleted. toBeDeleted should not be accessed after the call.
 
@@ -110,6 +132,23 @@ void giveMeTheTrail(DracView currentView, PlayerID player,
 //    return precise locations
 void giveMeTheMoves(DracView currentView, PlayerID player, LocationID trail[TRAIL_SIZE]);
 
+// giveMeTheWholeTrail() is giveMeTheTrail() for the whole game: it points
+//   at every location the player has been, oldest first (the one for
+//   round r at index r), and sets *numMoves to how many there are
+// The array is not a copy: it is only good until the view is updated
+
+const LocationID *giveMeTheWholeTrail(DracView currentView, PlayerID player, int *numMoves);
+
+// giveMeTheMessage() gives the message left with a play (0 is the first
+//   play), or "" if the view was not given one
+const char *giveMeTheMessage(DracView currentView, int play);
+
+// giveMeTheState() fills in a ViewState (see GameView.h) with what
+//   giveMeTheRound(), giveMeTheScore(), howHealthyIs(), whereIs(),
+//   giveMeTheTrail() and giveMeTheMoves() would give for every player,
+//   all in one call
+void giveMeTheState(DracView currentView, ViewState *state);
+
 
 //// Functions that query the map to find information about connectivity
 
@@ -147,6 +186,25 @@ LocationID *whereHuntersCanGoNext(DracView currentView, int *numLocations,
                            PlayerID player, int road, int rail, int sea);
 
 
+// threatSet() returns the set of locations from which a hunter can reach
+//   'where' within 'rounds' rounds (0 <= rounds <= MAX_THREAT_ROUNDS),
+//   if his first move is made with the given rail phase
+//   (ie (round + player) % 4, the number of rail stops allowed)
+// The sets for every location are worked out once, when the view is made,
+//   so a threat check is only a set intersection
+
+#define MAX_THREAT_ROUNDS 4
+
+LocationSet threatSet(DracView currentView, LocationID where, int rounds, int railPhase);
+
+// huntersThreatening() checks every hunter's current location against
+//   threatSet() for his rail phase in the next round
+// Returns a bitmask with bit h set if hunter h can reach 'where'
+//   within 'rounds' rounds
+
+int huntersThreatening(DracView currentView, LocationID where, int rounds);
+
+
 // Use connectLocations Function to find out all the adjacent locations
 LocationID *adjacentLocations(DracView currentView, int *numLocations);
 
@@ -0,0 +1,96 @@
+// GameBatch.c ... the states of many games at once
+//
+// A pool of threads share out the games BATCH_CHUNK at a time; the only
+// thing they share besides the (read only) place tables is the index of
+// the next chunk.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "Globals.h"
+#include "GameBatch.h"
+
+#define MAX_THREADS 64
+
+typedef struct batch {
+    char **pastPlays;
+    GameState *states;
+    int numGames;
+    int next;                   // first game no thread has taken yet
+    pthread_mutex_t lock;       // guards next
+} Batch;
+
+// *** Private functions ***
+static void *worker(void *arg);
+static int takeChunk(Batch *batch);
+
+
+// Sets each state to the state after the matching pastPlays
+void parseBatch(char *pastPlays[], int numGames, GameState states[], int numThreads)
+{
+    assert(numGames >= 0);
+    assert(numGames == 0 || (pastPlays != NULL && states != NULL));
+    assert(numThreads >= 0);
+
+    if(numThreads == 0) numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    if(numThreads > (numGames + BATCH_CHUNK - 1) / BATCH_CHUNK) {
+        numThreads = (numGames + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    }
+    if(numThreads < 1) numThreads = 1;
+
+    Batch batch;
+    batch.pastPlays = pastPlays;
+    batch.states = states;
+    batch.numGames = numGames;
+    batch.next = 0;
+    pthread_mutex_init(&batch.lock, NULL);
+
+    //this thread does a share as well; if a thread can't be started, the
+    //ones that were (or just this one) take the chunks it would have
+    pthread_t threads[MAX_THREADS];
+    int started;
+    for(started = 1; started < numThreads; started++) {
+        if(pthread_create(&threads[started], NULL, worker, &batch) != 0) break;
+    }
+    worker(&batch);
+
+    int i;
+    for(i = 1; i < started; i++) pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&batch.lock);
+}
+
+
+//// Private functions
+
+//Parses chunks of the batch until there are none left
+static void *worker(void *arg) {
+    Batch *batch = arg;
+
+    int first;
+    while((first = takeChunk(batch)) < batch->numGames) {
+        int last = first + BATCH_CHUNK < batch->numGames ? first + BATCH_CHUNK : batch->numGames;
+
+        int i;
+        for(i = first; i < last; i++) {
+            assert(batch->pastPlays[i] != NULL);
+            initGameState(&batch->states[i]);
+            applyPlaysToState(&batch->states[i], batch->pastPlays[i]);
+        }
+    }
+
+    return NULL;
+}
+
+//Returns the first game of the next chunk (numGames once there are none)
+static int takeChunk(Batch *batch) {
+    pthread_mutex_lock(&batch->lock);
+    int first = batch->next;
+    if(first < batch->numGames) batch->next += BATCH_CHUNK;
+    pthread_mutex_unlock(&batch->lock);
+
+    return first < batch->numGames ? first : batch->numGames;
+}
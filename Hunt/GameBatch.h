@@ -0,0 +1,22 @@
+// GameBatch.h ... the states of many games at once
+//
+// For analysis over recorded games: parseBatch() turns an array of
+// pastPlays strings into an array of GameStates, one per string, spread
+// over a few threads. A GameState needs no Map and no allocation, so each
+// thread writes straight into its own slices of the caller's array.
+
+#ifndef GAME_BATCH_H
+#define GAME_BATCH_H
+
+#include "GameState.h"
+
+// Positions each thread takes at a time
+#define BATCH_CHUNK 64
+
+// parseBatch() sets states[i] to the state after pastPlays[i] for each of
+// the numGames strings, using up to numThreads threads (0 for one per
+// processor). pastPlays and states must not overlap, and nothing else
+// may write to states until it returns.
+void parseBatch(char *pastPlays[], int numGames, GameState states[], int numThreads);
+
+#endif
@@ -0,0 +1,516 @@
+// GameState.c ... the rules of the game, applied one play at a time
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "Globals.h"
+#include "Check.h"
+#include "Game.h"
+#include "GameState.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define TRAIL_MASK ((1ULL << TRAIL_BITS) - 1)
+#define TRAIL_ALL  ((1ULL << (TRAIL_BITS * TRAIL_SIZE)) - 1)
+#define SLOTS_ALL  ((1 << TRAIL_SIZE) - 1)
+#define ACTION_MASK ((1 << ACTION_BITS) - 1)
+
+// scanPlays() reads each play as one 64 bit word, char i in byte i, and
+// tests all its chars at once (see bytesEqual())
+#define ONES         0x0101010101010101ULL
+#define LOWS         0x7f7f7f7f7f7f7f7fULL
+#define HIGH_BIT(i)  (0x80ULL << (8 * (i)))
+#define ACTION_CHARS (HIGH_BIT(3) | HIGH_BIT(4) | HIGH_BIT(5) | HIGH_BIT(6))
+#define SPACE_CHAR   HIGH_BIT(7)
+
+#if ACTION_BITS != 2
+#error "scanPlays() packs the action chars two bits each"
+#endif
+
+// *** Private functions ***
+static PlayerID whichPlayer(char c);
+static int whichActions(const char *play, PlayerID player);
+static uint64_t loadPlay(const char *play, int last);
+static uint64_t bytesEqual(uint64_t word, char c);
+static void validGameState(const GameState *state);
+static LocationID unpackTrail(unsigned long long trail, int back);
+static unsigned long long pushTrail(unsigned long long trail, LocationID id);
+static void hunterPlay(GameState *state, PlayerID player, LocationID currLoc, int actions);
+static void draculaPlay(GameState *state, LocationID move, int actions);
+
+
+// Sets up the state before anyone has played
+void initGameState(GameState *state)
+{
+    assert(state != NULL);
+    assert(sizeof(GameState) <= 64);           // one cache line
+    assert(TRAIL_BITS * TRAIL_SIZE <= 64);
+
+    memset(state, 0, sizeof(GameState));       //padding too, so states can be stored byte for byte
+    state->trailMoves = 0;                     // all UNKNOWN_LOCATION
+    state->trailLocations = 0;
+    state->turn = 0;
+    state->score = GAME_START_SCORE;
+
+    int i;
+    for(i = 0; i < NUM_PLAYERS; i++) {
+        state->health[i] = GAME_START_HUNTER_LIFE_POINTS;
+        state->location[i] = UNKNOWN_LOCATION;
+    }
+    state->health[PLAYER_DRACULA] = GAME_START_BLOOD_POINTS;
+
+    state->killed = 0;
+    state->traps = 0;
+    state->vamps = 0;
+}
+
+// Whether a state from elsewhere is one these functions can carry on from
+int checkGameState(const GameState *state)
+{
+    assert(state != NULL);
+
+    if(state->turn < 0 || state->turn > NUM_PLAYERS * GAME_START_SCORE) return FALSE;
+    if(state->score > GAME_START_SCORE) return FALSE;
+    if((state->trailMoves & ~TRAIL_ALL) != 0 || (state->trailLocations & ~TRAIL_ALL) != 0) return FALSE;
+    if((state->traps & ~SLOTS_ALL) != 0 || (state->vamps & ~SLOTS_ALL) != 0) return FALSE;
+    if((state->killed & ~((1 << PLAYER_DRACULA) - 1)) != 0) return FALSE;
+
+    PlayerID p;
+    for(p = 0; p < NUM_PLAYERS; p++) {
+        if(state->location[p] != UNKNOWN_LOCATION && !validMove(state->location[p])) return FALSE;
+        if(p == PLAYER_DRACULA) continue;
+        if(state->health[p] < 0 || state->health[p] > GAME_START_HUNTER_LIFE_POINTS) return FALSE;
+    }
+
+    //the trail's moves, and where they took him (HIDE, DOUBLE_BACK_n and TELEPORT don't say)
+    int i;
+    for(i = 0; i < TRAIL_SIZE; i++) {
+        LocationID move = unpackTrail(state->trailMoves, i);
+        LocationID where = unpackTrail(state->trailLocations, i);
+        if(move != UNKNOWN_LOCATION && !validMove(move)) return FALSE;
+        if(where != UNKNOWN_LOCATION && !validPlace(where) &&
+           where != CITY_UNKNOWN && where != SEA_UNKNOWN) return FALSE;
+    }
+
+    return TRUE;
+}
+
+// Makes one play and returns who made it
+PlayerID applyPlayToState(GameState *state, const char *play)
+{
+    assert(play != NULL);
+
+    DecodedPlay decoded;
+    decoded.player = whichPlayer(play[0]);
+    decoded.move = moveToID(play + 1);
+    decoded.actions = whichActions(play, decoded.player);
+    return applyDecodedToState(state, &decoded);
+}
+
+// Makes one decoded play and returns who made it
+PlayerID applyDecodedToState(GameState *state, const DecodedPlay *play)
+{
+    validGameState(state);
+    assert(play != NULL);
+
+    PlayerID player = play->player;
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    state->turn++;
+    state->killed &= ~(1 << player);           //he has left the hospital if he was there
+
+    if(player != PLAYER_DRACULA) {
+        hunterPlay(state, player, play->move, play->actions);
+    } else {
+        draculaPlay(state, play->move, play->actions);
+    }
+
+    //if the next player is a hunter who was killed by Dracula in the last round
+    //his health is restored and he can leave the hospital
+    PlayerID next = stateCurrentPlayer(state);
+    if(next != PLAYER_DRACULA && state->health[next] == 0) {
+        state->killed |= 1 << next;
+        state->health[next] = GAME_START_HUNTER_LIFE_POINTS;
+    }
+
+    return player;
+}
+
+// Makes every play in a pastPlays string
+void applyPlaysToState(GameState *state, const char *plays)
+{
+    assert(plays != NULL);
+
+    const char *play = plays;
+    if(*play == ' ') play++;                   //skip the space after the last play applied
+    for(; *play != '\0'; play += PLAY_LENGTH) {
+        applyPlayToState(state, play);
+        if(play[PLAY_LENGTH - 1] == '\0') break;   //the last play has no trailing space
+    }
+}
+
+// Checks and decodes the plays in the first 'length' chars of pastPlays
+int scanPlays(const char *plays, int length, DecodedPlay decoded[])
+{
+    assert(plays != NULL && decoded != NULL && length >= 0);
+
+    static const signed char players[256] = {       //player ID + 1 of each player char
+        ['G'] = PLAYER_LORD_GODALMING + 1, ['S'] = PLAYER_DR_SEWARD + 1,
+        ['H'] = PLAYER_VAN_HELSING + 1, ['M'] = PLAYER_MINA_HARKER + 1,
+        ['D'] = PLAYER_DRACULA + 1
+    };
+
+    if(length > 0 && *plays == ' ') {             //skip the space after the last play applied
+        plays++;
+        length--;
+    }
+    int numPlays = (length + 1) / PLAY_LENGTH;
+    if(length != numPlays * PLAY_LENGTH - 1 && length != numPlays * PLAY_LENGTH) return -1;
+
+    //no branches on the chars: any bad char sets a bit in 'bad', checked at the end
+    uint64_t bad = 0;
+    int i;
+    for(i = 0; i < numPlays; i++) {
+        const char *play = plays + i * PLAY_LENGTH;
+        uint64_t word = loadPlay(play, (i + 1) * PLAY_LENGTH > length);
+
+        uint64_t isT = bytesEqual(word, 'T'), isV = bytesEqual(word, 'V');
+        uint64_t isD = bytesEqual(word, 'D'), isM = bytesEqual(word, 'M');
+        uint64_t isAction = bytesEqual(word, '.') | isT | isV | isD | isM;
+        uint64_t good = (isAction & ACTION_CHARS) | (bytesEqual(word, ' ') & SPACE_CHAR);
+
+        PlayerID player = players[word & 0xff] - 1;
+        LocationID move = moveToID(play + 1);
+
+        //hunters meet Dracula (D), only Dracula's traps malfunction (M)
+        uint64_t notTheirs = player == PLAYER_DRACULA ? isD : isM;
+        bad |= (good ^ (ACTION_CHARS | SPACE_CHAR)) | (notTheirs & ACTION_CHARS) |
+               (player < 0) | (move == NOWHERE);
+
+        //each action char's code in its byte, then the four bytes packed into one
+        uint64_t codes = (isT >> 7) * ACTION_TRAP | (isV >> 7) * ACTION_VAMPIRE |
+                         ((isD | isM) >> 7) * ACTION_OTHER;
+        codes = codes >> (8 * 3);
+        codes |= codes >> (8 - ACTION_BITS);
+        codes |= codes >> (2 * (8 - ACTION_BITS));
+
+        decoded[i].player = player;
+        decoded[i].move = move;
+        decoded[i].actions = codes & 0xff;
+    }
+
+    return bad ? -1 : numPlays;
+}
+
+// Makes a play, noting what it changes
+void makeMove(GameState *state, Undo *undo, const char *play)
+{
+    validGameState(state);
+    assert(undo != NULL && play != NULL);
+
+    PlayerID player = stateCurrentPlayer(state);
+    assert(whichPlayer(play[0]) == player);
+
+    undo->score = state->score;
+    undo->health = state->health[player];
+    undo->dracHealth = state->health[PLAYER_DRACULA];
+    undo->location = state->location[player];
+    undo->killed = state->killed;
+    undo->traps = state->traps;
+    undo->vamps = state->vamps;
+
+    // the oldest move in Dracula's trail is the only thing his play loses
+    int oldest = TRAIL_BITS * (TRAIL_SIZE - 1);
+    undo->dropped = ((state->trailMoves >> oldest) & TRAIL_MASK) |
+                    ((state->trailLocations >> oldest) & TRAIL_MASK) << TRAIL_BITS;
+
+    applyPlayToState(state, play);
+}
+
+// Takes back the last play made
+void unmakeMove(GameState *state, const Undo *undo)
+{
+    validGameState(state);
+    assert(undo != NULL);
+    assert(state->turn > 0);
+
+    PlayerID next = stateCurrentPlayer(state);
+    state->turn--;
+    PlayerID player = stateCurrentPlayer(state);
+
+    //the next player was only let out of hospital if he had no health
+    if((state->killed & ~undo->killed) & (1 << next)) state->health[next] = 0;
+
+    state->score = undo->score;
+    state->health[player] = undo->health;
+    state->health[PLAYER_DRACULA] = undo->dracHealth;
+    state->location[player] = undo->location;
+    state->killed = undo->killed;
+    state->traps = undo->traps;
+    state->vamps = undo->vamps;
+
+    if(player == PLAYER_DRACULA) {
+        int oldest = TRAIL_BITS * (TRAIL_SIZE - 1);
+        state->trailMoves = (state->trailMoves >> TRAIL_BITS) |
+                            (unsigned long long) (undo->dropped & TRAIL_MASK) << oldest;
+        state->trailLocations = (state->trailLocations >> TRAIL_BITS) |
+                                (unsigned long long) (undo->dropped >> TRAIL_BITS) << oldest;
+    }
+}
+
+Round stateRound(const GameState *state)
+{
+    validGameState(state);
+    return (Round) (state->turn / NUM_PLAYERS);
+}
+
+PlayerID stateCurrentPlayer(const GameState *state)
+{
+    validGameState(state);
+    return (PlayerID) (state->turn % NUM_PLAYERS);
+}
+
+int stateScore(const GameState *state)
+{
+    validGameState(state);
+    return state->score;
+}
+
+int stateHealth(const GameState *state, PlayerID player)
+{
+    validGameState(state);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    return state->health[player];
+}
+
+LocationID stateLocation(const GameState *state, PlayerID player)
+{
+    validGameState(state);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+
+    if(player == PLAYER_DRACULA) {
+        //Dracula is teleported to his castle
+        if(state->location[player] == TELEPORT) return CASTLE_DRACULA;
+    } else {
+        //a hunter with no health, or killed last turn, is in the hospital
+        if(state->health[player] == 0) return ST_JOSEPH_AND_ST_MARYS;
+        if(state->killed & (1 << player)) return ST_JOSEPH_AND_ST_MARYS;
+    }
+
+    return state->location[player];
+}
+
+void stateDraculaTrail(const GameState *state, LocationID trail[TRAIL_SIZE])
+{
+    validGameState(state);
+    CHECK(trail != NULL);
+
+    int i;
+    for(i = 0; i < TRAIL_SIZE; i++) trail[i] = unpackTrail(state->trailMoves, i);
+}
+
+void stateDraculaLocations(const GameState *state, LocationID trail[TRAIL_SIZE])
+{
+    validGameState(state);
+    CHECK(trail != NULL);
+
+    int i;
+    for(i = 0; i < TRAIL_SIZE; i++) trail[i] = unpackTrail(state->trailLocations, i);
+}
+
+// Minions only exist along Dracula's trail, so count the trail moves that
+// took him to 'where' and left one there
+void stateMinions(const GameState *state, LocationID where,
+                  int *numTraps, int *numVamps)
+{
+    validGameState(state);
+    CHECK(validPlace(where));
+    CHECK(numTraps != NULL && numVamps != NULL);
+
+    *numTraps = 0;
+    *numVamps = 0;
+
+    int i;
+    for(i = 0; i < TRAIL_SIZE; i++) {
+        if(unpackTrail(state->trailLocations, i) != where) continue;
+        if(state->traps & (1 << i)) (*numTraps)++;
+        if(state->vamps & (1 << i)) (*numVamps)++;
+    }
+}
+
+// *** Private Functions ***
+
+static void validGameState(const GameState *state) {
+    CHECK(state != NULL);
+    CHECK_FULL(state->turn >= 0);
+    CHECK_FULL((state->trailMoves & ~TRAIL_ALL) == 0);
+    CHECK_FULL((state->trailLocations & ~TRAIL_ALL) == 0);
+    CHECK_FULL((state->traps & ~SLOTS_ALL) == 0 && (state->vamps & ~SLOTS_ALL) == 0);
+}
+
+// Returns Id of the player who made a play
+static PlayerID whichPlayer(char c) {
+    PlayerID id;
+
+    switch(c) {
+    case 'G': id = PLAYER_LORD_GODALMING; break;
+    case 'S': id = PLAYER_DR_SEWARD; break;
+    case 'H': id = PLAYER_VAN_HELSING; break;
+    case 'M': id = PLAYER_MINA_HARKER; break;
+    case 'D': id = PLAYER_DRACULA; break;
+    default: id = -1; break;
+    }
+
+    assert(id >= PLAYER_LORD_GODALMING && id <= PLAYER_DRACULA);
+    return id;
+}
+
+//Packs a play's action chars into ACTION_BITS each; anything but T, V and
+//a hunter's D or Dracula's M is ACTION_NONE
+static int whichActions(const char *play, PlayerID player) {
+    char other = player == PLAYER_DRACULA ? 'M' : 'D';
+    int actions = 0;
+
+    int j;
+    for(j = 3; j < PLAY_LENGTH - 1; j++) {
+        int action = ACTION_NONE;
+        if(play[j] == 'T') action = ACTION_TRAP;
+        else if(play[j] == 'V') action = ACTION_VAMPIRE;
+        else if(play[j] == other) action = ACTION_OTHER;
+
+        actions |= action << (ACTION_BITS * (j - 3));
+    }
+
+    return actions;
+}
+
+//Reads a play as a word, char i in byte i; the last play has no space
+//after it (and maybe nothing to read), so one is put there
+static uint64_t loadPlay(const char *play, int last) {
+    char chars[PLAY_LENGTH];
+    uint64_t word;
+
+    if(last) {
+        memcpy(chars, play, PLAY_LENGTH - 1);
+        chars[PLAY_LENGTH - 1] = ' ';
+        play = chars;
+    }
+    memcpy(&word, play, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+
+    return word;
+}
+
+//Returns the word with the high bit of each byte set if that byte is c,
+//and every other bit clear
+static uint64_t bytesEqual(uint64_t word, char c) {
+    uint64_t x = word ^ (ONES * (unsigned char) c);       //bytes that were c are now 0
+
+    return ~(((x & LOWS) + LOWS) | x | LOWS);
+}
+
+//Returns the move 'back' moves ago (0 = the latest) in a packed trail
+static LocationID unpackTrail(unsigned long long trail, int back) {
+    CHECK_FULL(back >= 0 && back < TRAIL_SIZE);
+
+    return (LocationID) ((trail >> (TRAIL_BITS * back)) & TRAIL_MASK) - 1;
+}
+
+//Adds a move to the front of a packed trail; the oldest one drops off
+static unsigned long long pushTrail(unsigned long long trail, LocationID id) {
+    assert(id + 1 >= 0 && (unsigned long long) (id + 1) <= TRAIL_MASK);
+
+    return ((trail << TRAIL_BITS) | (unsigned long long) (id + 1)) & TRAIL_ALL;
+}
+
+//A hunter moves, meets whatever is there and maybe rests
+static void hunterPlay(GameState *state, PlayerID player, LocationID currLoc, int actions) {
+    LocationID previous = state->location[player];
+    state->location[player] = currLoc;
+
+    int j, i;
+    for(j = 0; j < 4; j++) {
+
+        //restore to 9 HP if the hunter was killed by Dracula in last turn
+        if(state->health[player] == 0) state->health[player] = GAME_START_HUNTER_LIFE_POINTS;
+
+        int action = (actions >> (ACTION_BITS * j)) & ACTION_MASK;
+        if(action == ACTION_NONE) break;  //No more encounters
+
+        if(action == ACTION_TRAP) {
+            //Trigger the trap: the oldest one here on the trail goes
+            state->health[player] -= LIFE_LOSS_TRAP_ENCOUNTER;
+            for(i = TRAIL_SIZE - 1; i >= 0 && validPlace(currLoc); i--) {
+                if((state->traps & (1 << i)) && unpackTrail(state->trailLocations, i) == currLoc) {
+                    state->traps &= ~(1 << i);
+                    break;
+                }
+            }
+        } else if(action == ACTION_VAMPIRE) {
+            //Kill an immature vampire
+            for(i = 0; i < TRAIL_SIZE && validPlace(currLoc); i++) {
+                if(unpackTrail(state->trailLocations, i) == currLoc) state->vamps &= ~(1 << i);
+            }
+        } else if(action == ACTION_OTHER) {
+            //Confront Dracula
+            state->health[player] -= LIFE_LOSS_DRACULA_ENCOUNTER;
+            state->health[PLAYER_DRACULA] -= LIFE_LOSS_HUNTER_ENCOUNTER;
+        }
+
+        //No more actions when HP becomes ZERO --> HP = 0 and reduce the game score
+        if(state->health[player] <= 0) {
+            state->health[player] = 0;
+            state->score -= SCORE_LOSS_HUNTER_HOSPITAL;
+            break;
+        }
+    }
+
+    //take rest or research when staying at the same location (when HP is not zero)
+    if(currLoc == previous && state->health[player] > 0) {
+        state->health[player] += LIFE_GAIN_REST;
+        if(state->health[player] > GAME_START_HUNTER_LIFE_POINTS) {
+            state->health[player] = GAME_START_HUNTER_LIFE_POINTS;
+        }
+    }
+}
+
+//Dracula moves, maybe places a trap or vampire, and the oldest move
+//leaves his trail (taking its trap or vampire with it)
+static void draculaPlay(GameState *state, LocationID move, int actions) {
+    LocationID currLoc = move;
+
+    //HIDE and DOUBLE_BACK_n take him where an earlier move did, TELEPORT to his castle;
+    //from the hunters' view this may only be CITY_UNKNOWN or SEA_UNKNOWN
+    if(move == HIDE) {
+        currLoc = unpackTrail(state->trailLocations, 0);
+    } else if(move >= DOUBLE_BACK_1 && move <= DOUBLE_BACK_5) {
+        currLoc = unpackTrail(state->trailLocations, move - DOUBLE_BACK_1);
+    } else if(move == TELEPORT) {
+        currLoc = CASTLE_DRACULA;
+    }
+
+    state->location[PLAYER_DRACULA] = move;
+    state->trailMoves = pushTrail(state->trailMoves, move);
+    state->trailLocations = pushTrail(state->trailLocations, currLoc);
+    state->traps = (state->traps << 1) & SLOTS_ALL;
+    state->vamps = (state->vamps << 1) & SLOTS_ALL;
+
+    //Immature vampires become mature and game score will be reduced
+    if(((actions >> (2 * ACTION_BITS)) & ACTION_MASK) == ACTION_VAMPIRE) state->score -= SCORE_LOSS_VAMPIRE_MATURES;
+
+    if(currLoc == CASTLE_DRACULA) {
+        state->health[PLAYER_DRACULA] += LIFE_GAIN_CASTLE_DRACULA;
+    } else if(currLoc == SEA_UNKNOWN || (validPlace(currLoc) && idToType(currLoc) == SEA)) {
+        state->health[PLAYER_DRACULA] -= LIFE_LOSS_SEA;
+    }
+
+    if((actions & ACTION_MASK) == ACTION_TRAP) state->traps |= 1;
+    if(((actions >> ACTION_BITS) & ACTION_MASK) == ACTION_VAMPIRE) state->vamps |= 1;
+
+    //score - 1 when Dracula finishes his turn
+    state->score -= SCORE_LOSS_DRACULA_TURN;
+}
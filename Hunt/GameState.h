@@ -0,0 +1,118 @@
+// GameState.h ... the state of a game in a few dozen bytes
+//
+// Everything the rules need to carry on from one play to the next, kept
+// small enough to copy freely: search code can make as many as it likes
+// on the stack. Players' full histories are not part of it; a GameView
+// keeps those alongside its GameState for the functions that ask for them.
+
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "Globals.h"
+#include "Places.h"
+
+// Each play in pastPlays is PLAY_LENGTH chars: the player, a two char
+// location, four action chars and a separating space (except after the last)
+
+#define PLAY_LENGTH 8
+
+// A play's action chars, ACTION_BITS each, the first in the lowest bits
+#define ACTION_BITS      2
+#define ACTION_NONE      0      // '.'
+#define ACTION_TRAP      1      // 'T'
+#define ACTION_VAMPIRE   2      // 'V'
+#define ACTION_OTHER     3      // a hunter meeting Dracula ('D'), or a trap malfunctioning ('M')
+#define ACTION_HOSPITAL  (1 << (4 * ACTION_BITS))
+
+// Dracula's trail is packed TRAIL_BITS to a move (move ID + 1, so that
+// UNKNOWN_LOCATION packs to 0), the latest move in the lowest bits
+#define TRAIL_BITS 7
+
+// Treat the fields as private: use the functions below
+typedef struct gameState {
+    unsigned long long trailMoves;      // Dracula's last TRAIL_SIZE moves
+    unsigned long long trailLocations;  // where each of those moves took him
+    short turn;                         // number of plays made so far
+    short score;
+    short health[NUM_PLAYERS];
+    signed char location[NUM_PLAYERS];  // each player's latest move
+    unsigned char killed;               // hunters sent to hospital last turn, one bit each
+    unsigned char traps;                // trail moves whose trap is still there, one bit each
+    unsigned char vamps;                // trail moves whose vampire is still immature
+} GameState;
+
+// initGameState() sets up the state before anyone has played
+void initGameState(GameState *state);
+
+// checkGameState() says whether every field of a state that didn't come
+// from these functions (say one read from a file) is in range, so that
+// they can carry on from it. It doesn't replay the game to see whether
+// the state could really come about.
+int checkGameState(const GameState *state);
+
+// applyPlayToState() makes one play (PLAY_LENGTH - 1 chars, the separating
+// space is not needed) following exactly the rules a GameView uses, and
+// returns the player who made it
+PlayerID applyPlayToState(GameState *state, const char *play);
+
+// applyPlaysToState() makes every play in a pastPlays string (or the rest of
+// one; a leading space is allowed)
+void applyPlaysToState(GameState *state, const char *plays);
+
+// A play already taken apart, so it can be made without looking at its chars
+typedef struct decodedPlay {
+    signed char player;
+    signed char move;                   // moveToID() of the location chars
+    unsigned char actions;              // the action chars, ACTION_BITS each
+} DecodedPlay;
+
+// scanPlays() checks and decodes every play in the first 'length' chars of
+// a pastPlays string (or the rest of one; a leading space is allowed),
+// a whole play at a time rather than a char at a time. It returns the
+// number of plays, or -1 if any of them is not a player, a move and four
+// action chars of that player followed by a space (or the end).
+// 'decoded' needs room for (length + 1) / PLAY_LENGTH plays.
+int scanPlays(const char *plays, int length, DecodedPlay decoded[]);
+
+// applyDecodedToState() is applyPlayToState() for a decoded play
+PlayerID applyDecodedToState(GameState *state, const DecodedPlay *play);
+
+// makeMove() is applyPlayToState() for search code: it also fills in
+// 'undo' with just what unmakeMove() needs to take the play back again.
+// The play must be by the current player. Plays are taken back in the
+// reverse order they were made, e.g.
+//    Undo undo[MAX_DEPTH];
+//    makeMove(&state, &undo[depth], play);
+//    ... search deeper ...
+//    unmakeMove(&state, &undo[depth]);
+typedef struct undo {
+    short score;
+    short health;                       // the mover's
+    short dracHealth;
+    unsigned short dropped;             // Dracula's trail move and location that left it
+    signed char location;               // the mover's previous move
+    unsigned char killed;
+    unsigned char traps;
+    unsigned char vamps;
+} Undo;
+
+void makeMove(GameState *state, Undo *undo, const char *play);
+void unmakeMove(GameState *state, const Undo *undo);
+
+// These are the GameView functions of the same names, for a GameState
+Round stateRound(const GameState *state);
+PlayerID stateCurrentPlayer(const GameState *state);
+int stateScore(const GameState *state);
+int stateHealth(const GameState *state, PlayerID player);
+LocationID stateLocation(const GameState *state, PlayerID player);
+
+// Dracula's last TRAIL_SIZE moves as getHistory() gives them, and where
+// they took him as getLocationHistory() gives it
+void stateDraculaTrail(const GameState *state, LocationID trail[TRAIL_SIZE]);
+void stateDraculaLocations(const GameState *state, LocationID trail[TRAIL_SIZE]);
+
+// The traps and immature vampires known to be at the given location
+void stateMinions(const GameState *state, LocationID where,
+                  int *numTraps, int *numVamps);
+
+#endif
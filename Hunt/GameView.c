@@ -2,11 +2,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <string.h>
 #include <assert.h>
 #include "Globals.h"
+#include "Check.h"
 #include "Game.h"
 #include "GameView.h"
+#include "GameState.h"
 #include "Map.h"
 #include "Queue.h"
 
@@ -14,13 +17,41 @@
 #define FALSE 0
 
 //ADT(s)
+// Every move of each player, oldest first (append only). Views share it,
+// each reading only as many plays as it has seen; the first to make a
+// move after the last play any of them has seen adds it in place (see
+// appendMove()), and the others then take a copy of their own
+typedef struct history {
+   atomic_int refs;                             // views sharing it
+   atomic_int end;                              // plays written so far, by any of them
+   LocationID moves[NUM_PLAYERS][GAME_START_SCORE];
+   LocationID dracLocations[GAME_START_SCORE];  // where each of Dracula's moves took him
+   TurnRecord timeline[NUM_PLAYERS * GAME_START_SCORE];  // the score and health after each play
+} *History;
+
+// Every event, shared in the same way (most plays have none, so a view
+// usually makes several moves before it needs a copy of its own)
+typedef struct eventLog {
+   atomic_int refs;                             // views sharing it
+   Event *events;                               // in the order they happened
+   int *byType;                                 // byType[t * maxEvents + k]: the k'th event of type t
+   int numEvents;
+   int maxEvents;                               // room in events (and for each type in byType)
+   int numOfType[NUM_EVENT_TYPES];
+} *EventLog;
+
+#define MIN_EVENTS       64
+#define SCAN_PLAYS       64     // plays checked and decoded at a time
+
 struct gameView {
-   Map g;                        // The Map
-   int turn;                     // Turn number
-   int score;                    // The score of the game
-   int *isKilledLastTurn;        // whether player is killed last turn
-   int *health;                  // players' health in this turn
-   LocationID **trail_perPlayer; // stores trail for each player in 2D array
+   Map g;                        // The Map (shared with clones)
+   GameState state;              // Turn, score, health, locations and Dracula's trail
+   History history;              // every move of each player (shared with clones)
+   int numMoves[NUM_PLAYERS];    // how many of those moves are this view's
+   atomic_int claimed;           // how many of its latest plays it added in place, unseen by others
+   EventLog log;                 // every event (shared with clones)
+   PlayerMessage *messages;      // the caller's, read only when asked for
+   int numMessages;
 }; 
 
 
@@ -35,14 +66,28 @@ struct MapRep {
     int nV;
     int nE;
     VList connections[NUM_MAP_LOCATIONS]; 
+    atomic_int refs;
 };
 
 
 // *** Private functions ***
-static PlayerID whichPlayer(char c);
 static void validGameView(GameView gameView);
-static void frontInsert(LocationID **trail_perPlayer, PlayerID player, char *location);
+static void appendMove(GameView gameView, PlayerID player, LocationID id);
+static History newHistory(void);
+static void releaseHistory(History history);
+static void unclaimPlays(GameView gameView);
+static int validSnapshot(const Snapshot *snapshot);
+static EventLog newEventLog(void);
+static void releaseEventLog(EventLog log);
+static void growEvents(EventLog log, int maxEvents);
+static void recordEvents(GameView gameView, PlayerID player, int actions);
+static void addEvent(GameView gameView, int type, Round round, PlayerID player, LocationID where);
+static LocationID recentMove(GameView gameView, PlayerID player, int back);
+static int numPlays(GameView gameView);
+static void recordTurn(GameView gameView);
 static void railConnection(GameView gameView, int *reachable, LocationID from, int railMoves);
+static int saturatingAdd(int a, int b);
+static int saturatingMul(int a, int b);
 
 
 // Creates a new GameView to summarise the current state of the game
@@ -53,223 +98,239 @@ GameView newGameView(char *pastPlays, PlayerMessage messages[])
     assert(gameView != NULL);
     gameView->g = newMap();
     assert(gameView->g != NULL);
-    gameView->isKilledLastTurn = malloc(NUM_PLAYERS * sizeof(int));
-    assert(gameView->isKilledLastTurn != NULL);
-    gameView->health = malloc(NUM_PLAYERS * sizeof(int));
-    assert(gameView->health != NULL);
-    gameView->trail_perPlayer = malloc(NUM_PLAYERS * sizeof(LocationID *));
-    assert(gameView->trail_perPlayer != NULL);
- 
-    int i, j = 0;
-    for(i = 0; i < NUM_PLAYERS; i++) {
-        gameView->trail_perPlayer[i] = malloc(GAME_START_SCORE * sizeof(LocationID));
-        assert(gameView->trail_perPlayer[i] != NULL);
+    gameView->history = newHistory();
+    gameView->log = newEventLog();
+    gameView->claimed = 0;
 
-        for(j = 0; j < GAME_START_SCORE; j++){
-            gameView->trail_perPlayer[i][j] = UNKNOWN_LOCATION;           
-        }
-    }
+    int i;
+    for(i = 0; i < NUM_PLAYERS; i++) gameView->numMoves[i] = 0;
 
+    gameView->messages = messages;
+    gameView->numMessages = 0;
 
-    //Initial turn number and game score
-    gameView->turn = 1;
-    gameView->score = GAME_START_SCORE;    
+    initGameState(&gameView->state);
+    applyPlays(gameView, pastPlays);
+    if(messages != NULL) gameView->numMessages = numPlays(gameView);
 
-    //The health of players at the beginning of the game
-    for(i = 0; i < PLAYER_DRACULA; i++) {
-        gameView->isKilledLastTurn[i] = FALSE;
-        gameView->health[i] = GAME_START_HUNTER_LIFE_POINTS;
-    }
-    gameView->isKilledLastTurn[i] = FALSE;
-    gameView->health[i] = GAME_START_BLOOD_POINTS;    
-
-    //Scanning through the pastPlays string to obtain necessary information
-    int interval = 8; 
-    for(i = 0; i < strlen(pastPlays); i += interval) {
-        gameView->turn++;                             //increase the turn number by 1
-        PlayerID player = whichPlayer(pastPlays[i]);  //find out which player 
-
-        char *location = malloc(4 * sizeof(char));    //get the abbreviation of locations
-        assert(location != NULL);
-        for(j = 0; j < 4; j++) location[j] = 0;
-        location[0] = pastPlays[i+1];
-        location[1] = pastPlays[i+2];
-
-        //Update the trail of the current player(Hunter)
-        frontInsert(gameView->trail_perPlayer, player, location); 
-        free(location);
-
-        //player = one of the Hunters
-        if(player != PLAYER_DRACULA) {
-            for(j = i + 3; j < i + interval - 1; j++) {
-
-                //restore to 9 HP if the hunter was killed by Dracula in last turn
-                if(gameView->health[player] == 0) {
-                    gameView->health[player] = GAME_START_HUNTER_LIFE_POINTS;
-                } 
-
-                if(pastPlays[j] == '.') break;  //No more encounters --> exit the loop by break       
-                
-                //Trigger the trap(s)
-                if(pastPlays[j] == 'T') {
-                    gameView->health[player] -= LIFE_LOSS_TRAP_ENCOUNTER;
-                } else if(pastPlays[j] == 'D') {         
-                    //Confront Dracula 
-                    gameView->health[player] -= LIFE_LOSS_DRACULA_ENCOUNTER;
-                    gameView->health[PLAYER_DRACULA] -= LIFE_LOSS_HUNTER_ENCOUNTER;   
-                }
+    return gameView;
+}
+     
+// Updates the GameView with plays made since it was created or last updated
+void applyPlays(GameView gameView, const char *newPlays)
+{
+    assert(newPlays != NULL);
+    applyPlaysLength(gameView, newPlays, strlen(newPlays));
+}
 
-                //No more actions when HP becomes ZERO --> HP = 0 and reduce the game score
-                if(gameView->health[player] <= 0) {
-                    gameView->health[player] = 0;
-                    gameView->score -= SCORE_LOSS_HUNTER_HOSPITAL;
-                    break;
-                } 
-            }
-            
-            //When hunter stays at the same location as the previous turn (when HP is not zero)
-            if((gameView->trail_perPlayer[player][0] == gameView->trail_perPlayer[player][1]) && 
-                gameView->health[player] > 0) {
-                //take rest or research at the same location
-                gameView->health[player] += LIFE_GAIN_REST;
-
-                //make sure Hunter HP does not exceed the limit (i.e HP <= 9)
-                if(gameView->health[player] > GAME_START_HUNTER_LIFE_POINTS) {
-                    gameView->health[player] = GAME_START_HUNTER_LIFE_POINTS;
-                }
-            }        
-        } else {
-            //player = Dracula
-             
-            //Immuture vampires become mature and game score will be reduced
-            if(pastPlays[i+5] == 'V') gameView->score -= SCORE_LOSS_VAMPIRE_MATURES;
-           
-            // Find where Dracula is (at an unknown/known sea, his castle, on land, ......)
-            int pos = 0;
-            LocationID currLoc = gameView->trail_perPlayer[player][0];
-            if(currLoc >= MIN_MAP_LOCATION && currLoc <= MAX_MAP_LOCATION) {
-                pos = 0;
-            } else if(currLoc >= DOUBLE_BACK_1 && currLoc <= DOUBLE_BACK_5) {
-                pos = currLoc - DOUBLE_BACK_1 + 1;
-                currLoc = gameView->trail_perPlayer[player][pos];
-
-                if(currLoc == HIDE) currLoc = gameView->trail_perPlayer[player][pos+1];
-            } else if(currLoc == HIDE) {
-                pos = 1;
-                currLoc = gameView->trail_perPlayer[player][pos];
-                
-                if(currLoc >= DOUBLE_BACK_1 && currLoc <= DOUBLE_BACK_5) {
-                   pos += currLoc - DOUBLE_BACK_1 + 1;
-                   currLoc = gameView->trail_perPlayer[player][pos];
-                }
+// Updates the GameView with the plays in the first 'length' chars of newPlays
+void applyPlaysLength(GameView gameView, const char *newPlays, int length)
+{
+    validGameView(gameView);
+    assert(newPlays != NULL && length >= 0);
+
+    //Checking and decoding the new plays SCAN_PLAYS at a time, then making them
+    DecodedPlay decoded[SCAN_PLAYS];
+    const char *play = newPlays;
+    const char *end = newPlays + length;
+    while(play < end) {
+        int chunk = end - play < SCAN_PLAYS * PLAY_LENGTH ? end - play : SCAN_PLAYS * PLAY_LENGTH;
+        int numDecoded = scanPlays(play, chunk, decoded);
+        assert(numDecoded >= 0);
+        play += chunk;
+
+        int i;
+        for(i = 0; i < numDecoded; i++) {
+            PlayerID player = applyDecodedToState(&gameView->state, &decoded[i]);
+            appendMove(gameView, player, decoded[i].move);
+
+            if(player == PLAYER_DRACULA) {
+                LocationID trail[TRAIL_SIZE];
+                stateDraculaLocations(&gameView->state, trail);
+                gameView->history->dracLocations[gameView->numMoves[PLAYER_DRACULA] - 1] = trail[0];
             }
+            recordTurn(gameView);
 
-            if(currLoc == TELEPORT) currLoc = CASTLE_DRACULA;
-             
-            if(currLoc == CASTLE_DRACULA) {
-                gameView->health[player] += LIFE_GAIN_CASTLE_DRACULA;    //gain HP as Dracula is in his castle
-            } else if(currLoc >= MIN_MAP_LOCATION && currLoc <= MAX_MAP_LOCATION) {
-
-                //lose 2 HP when Dracula is at the sea
-                if(idToType(currLoc) == SEA) {
-                    gameView->health[player] -= LIFE_LOSS_SEA;
-                } 
-            } else if(currLoc == SEA_UNKNOWN) {
-                gameView->health[player] -= LIFE_LOSS_SEA;
+            //most plays have no events: no actions and nobody sent to hospital
+            int hospital = player != PLAYER_DRACULA && stateHealth(&gameView->state, player) == 0;
+            if(hospital || decoded[i].actions != 0) {
+                recordEvents(gameView, player, decoded[i].actions | (hospital ? ACTION_HOSPITAL : 0));
             }
- 
-            //score - 1 when Dracula finishes his turn
-            gameView->score -= SCORE_LOSS_DRACULA_TURN;    
         }
-    }  
-
-    //if current player is hunter and got killed by Dracula in last round
-    //his health will be restored and can leave the hospital
-    PlayerID currentPlayer = getCurrentPlayer(gameView);
-    if(currentPlayer != PLAYER_DRACULA) {
-        if(gameView->health[currentPlayer] == 0) {
-            gameView->isKilledLastTurn[currentPlayer] = TRUE;
-            gameView->health[currentPlayer] = GAME_START_HUNTER_LIFE_POINTS;
+    }
+}
+
+// Lays the GameView out flat
+void takeSnapshot(GameView currentView, Snapshot *snapshot)
+{
+    validGameView(currentView);
+    assert(snapshot != NULL);
+
+    memset(snapshot, 0, sizeof(Snapshot));     //so equal views give equal bytes
+    snapshot->magic = SNAPSHOT_MAGIC;
+    snapshot->version = SNAPSHOT_VERSION;
+    snapshot->state = currentView->state;
+
+    int i, j;
+    for(i = 0; i < NUM_PLAYERS; i++) {
+        snapshot->numMoves[i] = currentView->numMoves[i];
+        for(j = 0; j < currentView->numMoves[i]; j++) {
+            snapshot->moves[i][j] = currentView->history->moves[i][j];
+        }
+    }
+    for(j = 0; j < currentView->numMoves[PLAYER_DRACULA]; j++) {
+        snapshot->dracLocations[j] = currentView->history->dracLocations[j];
+    }
+    memcpy(snapshot->timeline, currentView->history->timeline, numPlays(currentView) * sizeof(TurnRecord));
+
+    //the events of each play, as its action chars (see recordEvents())
+    int numActions = 0;
+    for(i = 0; i < currentView->log->numEvents; i++) {
+        Event *e = &currentView->log->events[i];
+        unsigned short *actions = &snapshot->actions[e->player][e->round];
+        if(i == 0 || e->round != e[-1].round || e->player != e[-1].player) numActions = 0;
+
+        switch(e->type) {
+        case EVENT_TRAP:             *actions |= ACTION_TRAP << (ACTION_BITS * numActions++); break;
+        case EVENT_VAMPIRE_KILLED:   *actions |= ACTION_VAMPIRE << (ACTION_BITS * numActions++); break;
+        case EVENT_DRACULA:          *actions |= ACTION_OTHER << (ACTION_BITS * numActions++); break;
+        case EVENT_HOSPITAL:         *actions |= ACTION_HOSPITAL; break;
+        case EVENT_TRAP_PLACED:      *actions |= ACTION_TRAP; break;
+        case EVENT_VAMPIRE_PLACED:   *actions |= ACTION_VAMPIRE << ACTION_BITS; break;
+        case EVENT_TRAP_MALFUNCTION: *actions |= ACTION_OTHER << (2 * ACTION_BITS); break;
+        case EVENT_VAMPIRE_MATURED:  *actions |= ACTION_VAMPIRE << (2 * ACTION_BITS); break;
         }
     }
-     
+}
+
+// Makes a GameView from a snapshot, or NULL if it isn't one
+GameView restoreGameView(const Snapshot *snapshot)
+{
+    assert(snapshot != NULL);
+    if(!validSnapshot(snapshot)) return NULL;
+
+    GameView gameView = malloc(sizeof(struct gameView));
+    assert(gameView != NULL);
+    gameView->g = newMap();
+    gameView->history = newHistory();
+    gameView->log = newEventLog();
+    gameView->claimed = 0;
+    gameView->state = snapshot->state;
+    gameView->messages = NULL;
+    gameView->numMessages = 0;
+
+    int i, j;
+    for(i = 0; i < NUM_PLAYERS; i++) {
+        gameView->numMoves[i] = snapshot->numMoves[i];
+        for(j = 0; j < snapshot->numMoves[i]; j++) {
+            gameView->history->moves[i][j] = snapshot->moves[i][j];
+        }
+    }
+    for(j = 0; j < snapshot->numMoves[PLAYER_DRACULA]; j++) {
+        gameView->history->dracLocations[j] = snapshot->dracLocations[j];
+    }
+    memcpy(gameView->history->timeline, snapshot->timeline, numPlays(gameView) * sizeof(TurnRecord));
+    gameView->history->end = numPlays(gameView);
+
+    //the events, play by play in the order they were made
+    int turn, numTurns = 0;
+    for(i = 0; i < NUM_PLAYERS; i++) numTurns += snapshot->numMoves[i];
+    for(turn = 0; turn < numTurns; turn++) {
+        Round round = turn / NUM_PLAYERS;
+        PlayerID player = turn % NUM_PLAYERS;
+
+        if(snapshot->actions[player][round] == 0) continue;
+        gameView->numMoves[player] = round + 1;   //as it was after the play
+        recordEvents(gameView, player, snapshot->actions[player][round]);
+    }
+    for(i = 0; i < NUM_PLAYERS; i++) gameView->numMoves[i] = snapshot->numMoves[i];
+
     return gameView;
 }
-     
+
 // Frees all memory previously allocated for the GameView toBeDeleted
 void disposeGameView(GameView toBeDeleted)
 {
     validGameView(toBeDeleted);    
 
-    int i = 0;
-    for(i = 0; i < NUM_PLAYERS; i++) {
-        assert(toBeDeleted->trail_perPlayer[i] != NULL);
-        free(toBeDeleted->trail_perPlayer[i]); 
-    }
-
     disposeMap(toBeDeleted->g);
-    free(toBeDeleted->trail_perPlayer); 
-    free(toBeDeleted->isKilledLastTurn);
-    free(toBeDeleted->health);
+    unclaimPlays(toBeDeleted);
+    releaseHistory(toBeDeleted->history);
+    releaseEventLog(toBeDeleted->log);
     free(toBeDeleted);
 }
 
+// Copies the GameView, sharing its map and history until either moves on
+GameView cloneGameView(GameView original)
+{
+    validGameView(original);
+
+    GameView clone = malloc(sizeof(struct gameView));
+    assert(clone != NULL);
+    clone->g = shareMap(original->g);
+    clone->state = original->state;
+    clone->history = original->history;
+    clone->history->refs++;
+    memcpy(clone->numMoves, original->numMoves, sizeof(original->numMoves));
+    clone->log = original->log;
+    clone->log->refs++;
+    clone->messages = original->messages;
+    clone->numMessages = original->numMessages;
+
+    //the clone sees the original's plays, so they are no longer the original's alone
+    clone->claimed = 0;
+    if(original->claimed > 0) original->claimed = 0;
+
+    return clone;
+}
+
 //// Functions that return simple information about the current state of the game
 
 // Get the current round
 Round getRound(GameView currentView)
 { 
     validGameView(currentView); 
-    Round round = (Round) ((currentView->turn - 1) / 5);
-    return round;
+    return stateRound(&currentView->state);
 }
 
 // Get the id of current player - ie whose turn is it?
 PlayerID getCurrentPlayer(GameView currentView)
 { 
     validGameView(currentView); 
-    PlayerID player = (PlayerID) ((currentView->turn - 1) % NUM_PLAYERS);
-    return player;
+    return stateCurrentPlayer(&currentView->state);
 }
 
 // Get the current score
 int getScore(GameView currentView)
 {
     validGameView(currentView); 
-    return currentView->score;
+    return stateScore(&currentView->state);
 }
 
 // Get the current health points for a given player
 int getHealth(GameView currentView, PlayerID player)
 {
     validGameView(currentView); 
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
 
+    int health = stateHealth(&currentView->state, player);
     if(player != PLAYER_DRACULA) {
-        assert(currentView->health[player] >= 0 && currentView->health[player] <= GAME_START_HUNTER_LIFE_POINTS);
-        return currentView->health[player];
+        CHECK_FULL(health >= 0 && health <= GAME_START_HUNTER_LIFE_POINTS);
+        return health;
     } 
         
-    assert(currentView->health[PLAYER_DRACULA] > 0);
-    return currentView->health[PLAYER_DRACULA];
+    CHECK_FULL(health > 0);
+    return health;
 }
 
 // Get the current location id of a given player
 LocationID getLocation(GameView currentView, PlayerID player)
 {
     validGameView(currentView); 
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
-
-    if(player == PLAYER_DRACULA) {
-        //Dracula is teleported to his castle
-        if(currentView->trail_perPlayer[player][0] == TELEPORT) return CASTLE_DRACULA;
-    } else {
-        //if the current health or the health in last turn is ZERO, then the hunter must be in the hospital
-        if(currentView->health[player] == 0) return ST_JOSEPH_AND_ST_MARYS;
-        if(currentView->isKilledLastTurn[player] == TRUE) return ST_JOSEPH_AND_ST_MARYS;   
-    }
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
 
-    return currentView->trail_perPlayer[player][0];
+    //a hunter with no health, or killed last turn, is in the hospital;
+    //Dracula's teleport takes him to his castle
+    return stateLocation(&currentView->state, player);
 }
 
 //// Functions that return information about the history of the game
@@ -279,10 +340,189 @@ void getHistory(GameView currentView, PlayerID player,
                             LocationID trail[TRAIL_SIZE])
 {
     validGameView(currentView); 
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
     
     int i;
-    for(i = 0; i < TRAIL_SIZE; i++) trail[i] = currentView->trail_perPlayer[player][i];
+    for(i = 0; i < TRAIL_SIZE; i++) trail[i] = recentMove(currentView, player, i);
+}
+
+// Fills the trail array with where the player was in the last 6 turns
+void getLocationHistory(GameView currentView, PlayerID player,
+                        LocationID trail[TRAIL_SIZE])
+{
+    validGameView(currentView); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+
+    if(player != PLAYER_DRACULA) {
+        getHistory(currentView, player, trail);
+        return;
+    }
+
+    stateDraculaLocations(&currentView->state, trail);
+}
+
+// Finds the traps and immature vampires known to be at the given location
+void getMinions(GameView currentView, LocationID where,
+                int *numTraps, int *numVamps)
+{
+    validGameView(currentView); 
+    CHECK(where >= MIN_MAP_LOCATION && where <= MAX_MAP_LOCATION);
+    CHECK(numTraps != NULL && numVamps != NULL);
+
+    stateMinions(&currentView->state, where, numTraps, numVamps);
+}
+
+// Points at all of the player's moves, oldest first
+const LocationID *getMoves(GameView currentView, PlayerID player, int *numMoves)
+{
+    validGameView(currentView); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(numMoves != NULL);
+
+    *numMoves = currentView->numMoves[player];
+    return currentView->history->moves[player];
+}
+
+// Points at everywhere the player has been, oldest first
+const LocationID *getLocations(GameView currentView, PlayerID player, int *numMoves)
+{
+    const LocationID *moves = getMoves(currentView, player, numMoves);
+    if(player != PLAYER_DRACULA) return moves;
+
+    return currentView->history->dracLocations;
+}
+
+// Points at the player's move in the given round, or NULL
+const LocationID *getMoveInRound(GameView currentView, PlayerID player, Round round)
+{
+    int numMoves;
+    const LocationID *moves = getMoves(currentView, player, &numMoves);
+    CHECK(round >= 0);
+
+    if(round >= numMoves) return NULL;
+    return &moves[round];
+}
+
+// Points at where the player was in the given round, or NULL
+const LocationID *getLocationInRound(GameView currentView, PlayerID player, Round round)
+{
+    int numMoves;
+    const LocationID *locations = getLocations(currentView, player, &numMoves);
+    CHECK(round >= 0);
+
+    if(round >= numMoves) return NULL;
+    return &locations[round];
+}
+
+// Points at all the events so far
+const Event *getEvents(GameView currentView, int *numEvents)
+{
+    validGameView(currentView); 
+    CHECK(numEvents != NULL);
+
+    *numEvents = currentView->log->numEvents;
+    return currentView->log->events;
+}
+
+// Counts the events of a type
+int numEventsOfType(GameView currentView, int type)
+{
+    validGameView(currentView); 
+    CHECK(type >= 0 && type < NUM_EVENT_TYPES);
+
+    return currentView->log->numOfType[type];
+}
+
+// Points at the k'th event of a type, or NULL
+const Event *getEventOfType(GameView currentView, int type, int k)
+{
+    validGameView(currentView); 
+    CHECK(type >= 0 && type < NUM_EVENT_TYPES);
+    CHECK(k >= 0);
+
+    EventLog log = currentView->log;
+    if(k >= log->numOfType[type]) return NULL;
+    return &log->events[log->byType[type * log->maxEvents + k]];
+}
+
+// Points at the latest event of a type before the given round, or NULL
+const Event *lastEventBefore(GameView currentView, int type, Round round)
+{
+    validGameView(currentView); 
+    CHECK(type >= 0 && type < NUM_EVENT_TYPES);
+
+    // the first event of the type in the round or later is at 'high'
+    EventLog log = currentView->log;
+    int *ofType = &log->byType[type * log->maxEvents];
+    int low = 0, high = log->numOfType[type];
+    while(low < high) {
+        int mid = (low + high) / 2;
+        if(log->events[ofType[mid]].round < round) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if(high == 0) return NULL;
+    return &log->events[ofType[high - 1]];
+}
+
+// The score after the given number of plays
+int getScoreAfter(GameView currentView, int plays)
+{
+    validGameView(currentView); 
+    CHECK(plays >= 0 && plays <= numPlays(currentView));
+
+    if(plays == 0) return GAME_START_SCORE;
+    return currentView->history->timeline[plays - 1].score;
+}
+
+// A player's health after the given number of plays
+int getHealthAfter(GameView currentView, PlayerID player, int plays)
+{
+    validGameView(currentView); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(plays >= 0 && plays <= numPlays(currentView));
+
+    if(plays == 0) {
+        return player == PLAYER_DRACULA ? GAME_START_BLOOD_POINTS : GAME_START_HUNTER_LIFE_POINTS;
+    }
+
+    TurnRecord *record = &currentView->history->timeline[plays - 1];
+    if(player == PLAYER_DRACULA) return record->dracHealth;
+    return (record->hunterHealth >> (HUNTER_HEALTH_BITS * player)) & ((1 << HUNTER_HEALTH_BITS) - 1);
+}
+
+// The message left with a play
+const char *getMessage(GameView currentView, int play)
+{
+    validGameView(currentView); 
+    CHECK(play >= 0 && play < numPlays(currentView));
+
+    if(play >= currentView->numMessages) return "";
+    return currentView->messages[play];
+}
+
+// Everything about the present in one go
+void getViewState(GameView currentView, ViewState *state)
+{
+    validGameView(currentView); 
+    CHECK(state != NULL);
+
+    state->round = stateRound(&currentView->state);
+    state->currentPlayer = stateCurrentPlayer(&currentView->state);
+    state->score = stateScore(&currentView->state);
+
+    PlayerID p;
+    int i;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        state->health[p] = stateHealth(&currentView->state, p);
+        state->location[p] = stateLocation(&currentView->state, p);
+        for(i = 0; i < TRAIL_SIZE; i++) state->moves[p][i] = recentMove(currentView, p, i);
+        if(p != PLAYER_DRACULA) memcpy(state->trail[p], state->moves[p], sizeof(state->moves[p]));
+    }
+    stateDraculaLocations(&currentView->state, state->trail[PLAYER_DRACULA]);
 }
 
 //// Functions that query the map to find information about connectivity
@@ -293,8 +533,8 @@ LocationID *connectedLocations(GameView currentView, int *numLocations,
                                int road, int rail, int sea)
 {
     validGameView(currentView); 
-    assert(numLocations != NULL);   // check that there is a location to visit
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(numLocations != NULL);   // check that there is a location to visit
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
     
     //If the location of the player is unknown (for example, HIDE, CITY_UNKNOWN, ......)
     if(from < MIN_MAP_LOCATION || from > MAX_MAP_LOCATION) {
@@ -304,8 +544,31 @@ LocationID *connectedLocations(GameView currentView, int *numLocations,
     
 
     // An array which tells which location can be reached (depends on the 3 parameters - road, rail, sea)
-    int *reachable = malloc(NUM_MAP_LOCATIONS * sizeof(int));
-    assert(reachable != NULL);
+    int reachable[NUM_MAP_LOCATIONS];
+    reachableFrom(currentView, reachable, from, player, round, road, rail, sea);
+
+    // The size of the array is stored in the variable pointed to by numLocations
+    LocationID *connLocations = malloc(NUM_MAP_LOCATIONS * sizeof(LocationID));
+    assert(connLocations != NULL);
+
+    int i, length = 0;
+    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
+        if(reachable[i] == 1) connLocations[length++] = i;
+    }
+
+    CHECK_FULL(length >= 1);     //as it is possible to stay at the same place
+    *numLocations = length;  //length of the connLocations array
+   
+    return connLocations;
+}
+
+// Marks the locations reachable in one move (without allocating)
+void reachableFrom(GameView currentView, int reachable[NUM_MAP_LOCATIONS], LocationID from, PlayerID player,
+                   Round round, int road, int rail, int sea)
+{
+    validGameView(currentView);
+    CHECK(reachable != NULL);
+    CHECK(from >= MIN_MAP_LOCATION && from <= MAX_MAP_LOCATION);
 
     //Initialise the array
     int i;
@@ -317,7 +580,7 @@ LocationID *connectedLocations(GameView currentView, int *numLocations,
     //Start looking for connected cities and seas 
     // **  this function won't take Dracula's trail into account (as required) **
     if(player == PLAYER_DRACULA) {
-        assert(from != ST_JOSEPH_AND_ST_MARYS); // Darcula is impossibly in the hospital
+        CHECK_FULL(from != ST_JOSEPH_AND_ST_MARYS); // Darcula is impossibly in the hospital
 
         while(curr != NULL){
             if(road == TRUE) {
@@ -361,170 +624,487 @@ LocationID *connectedLocations(GameView currentView, int *numLocations,
         }
 
     }
+}
 
-    // The size of the array is stored in the variable pointed to by numLocations
-    LocationID *connLocations = malloc(NUM_MAP_LOCATIONS * sizeof(LocationID));
-    assert(connLocations != NULL);
+// Counts the shortest routes from 'from' with a single breadth-first search
+// The search runs over (location, rail phase) pairs, as how far a hunter can
+// go by rail depends on the round the move is made in
+void pathCounts(GameView currentView, LocationID from, LocationID to, PlayerID player, Round round,
+                int road, int rail, int sea, int dist[NUM_MAP_LOCATIONS],
+                int numPaths[NUM_MAP_LOCATIONS], int through[NUM_MAP_LOCATIONS])
+{
+    validGameView(currentView);
+    CHECK(from >= MIN_MAP_LOCATION && from <= MAX_MAP_LOCATION);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(dist != NULL && numPaths != NULL);
+
+    // Dracula never takes the train, so the phase makes no difference for him
+    int numPhases = (rail == TRUE && player != PLAYER_DRACULA) ? NUM_RAIL_PHASES : 1;
+    int numStates = NUM_MAP_LOCATIONS * numPhases;
+
+    int i, k;
+    int stateDist[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    int statePaths[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    for(i = 0; i < numStates; i++) {
+        stateDist[i] = NO_PATH;
+        statePaths[i] = 0;
+    }
+
+    // the states in the order they were reached, and the shortest-route DAG edges
+    // (onRoute[s][v] when s -> v is a move on some shortest route), so that the
+    // DAG can be walked backwards afterwards without another search
+    int order[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    char onRoute[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES][NUM_MAP_LOCATIONS];
+    int numReached = 0;
+
+    int start = from * numPhases + round % numPhases;
+    stateDist[start] = 0;
+    statePaths[start] = 1;
+
+    LocationID storage[QUEUE_WORDS(NUM_MAP_LOCATIONS * NUM_RAIL_PHASES)];
+    Queue q = queueIn(storage, NUM_MAP_LOCATIONS * NUM_RAIL_PHASES);
+    enterQueue(q, start);
+
+    while(!emptyQueue(q)) {
+        int s = leaveQueue(q);
+        LocationID loc = s / numPhases;
+        int phase = s % numPhases;
+        int nextPhase = (phase + 1) % numPhases;
+        order[numReached++] = s;
+
+        int reachable[NUM_MAP_LOCATIONS];
+        reachableFrom(currentView, reachable, loc, player, phase, road, rail, sea);
+
+        for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
+            onRoute[s][i] = FALSE;
+            if(!reachable[i] || i == loc) continue;
+
+            int t = i * numPhases + nextPhase;
+            if(stateDist[t] == NO_PATH) {
+                stateDist[t] = stateDist[s] + 1;
+                enterQueue(q, t);
+            }
+
+            if(stateDist[t] == stateDist[s] + 1) {
+                statePaths[t] = saturatingAdd(statePaths[t], statePaths[s]);
+                onRoute[s][i] = TRUE;
+            }
+        }
+    }
 
-    int length = 0;
+    // A location is first reached in exactly one phase (the phase follows the turn)
     for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        if(reachable[i] == 1) connLocations[length++] = i;
+        dist[i] = NO_PATH;
+        numPaths[i] = 0;
+        for(k = 0; k < numPhases; k++) {
+            int d = stateDist[i * numPhases + k];
+            if(d == NO_PATH) continue;
+
+            if(dist[i] == NO_PATH || d < dist[i]) {
+                dist[i] = d;
+                numPaths[i] = statePaths[i * numPhases + k];
+            }
+        }
     }
 
-    free(reachable); 
-    assert(length >= 1);     //as it is possible to stay at the same place
-    *numLocations = length;  //length of the connLocations array
-   
-    return connLocations;
+    if(through == NULL) return;
+    for(i = 0; i < NUM_MAP_LOCATIONS; i++) through[i] = 0;
+    if(to < MIN_MAP_LOCATION || to > MAX_MAP_LOCATION || dist[to] == NO_PATH) return;
+
+    // Count the routes from each state on to 'to' by walking the DAG in reverse
+    // order; routes through v = (routes from->v) * (routes v->to)
+    int toEnd[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    for(i = 0; i < numStates; i++) toEnd[i] = 0;
+    toEnd[to * numPhases + (round + dist[to]) % numPhases] = 1;
+
+    for(k = numReached - 1; k >= 0; k--) {
+        int s = order[k];
+        int nextPhase = (s % numPhases + 1) % numPhases;
+
+        for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
+            if(onRoute[s][i]) toEnd[s] = saturatingAdd(toEnd[s], toEnd[i * numPhases + nextPhase]);
+        }
+    }
+
+    // With rail, a shortest route can come back to a location in a later
+    // phase; it is counted once, at its first visit. A location on the
+    // routes in just one phase has routes through it = (routes from->v) *
+    // (routes v->to); otherwise the routes reaching each of its states
+    // without having been there before are counted with another pass,
+    // from the round of its first state (the routes to that are all first
+    // visits) to its last state
+    int numOnRoute[NUM_MAP_LOCATIONS], first[NUM_MAP_LOCATIONS], last[NUM_MAP_LOCATIONS];
+    for(i = 0; i < NUM_MAP_LOCATIONS; i++) numOnRoute[i] = 0;
+    for(k = 0; k < numReached; k++) {
+        int s = order[k];
+        LocationID loc = s / numPhases;
+        if(toEnd[s] == 0) continue;
+        if(numOnRoute[loc]++ == 0) first[loc] = k;
+        last[loc] = k;
+        through[loc] = saturatingMul(statePaths[s], toEnd[s]);
+    }
+
+    LocationID v;
+    for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+        if(numOnRoute[v] < 2) continue;
+
+        int firstPaths[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+        int firstDist = stateDist[order[first[v]]];
+        for(i = 0; i < numStates; i++) {
+            firstPaths[i] = stateDist[i] != NO_PATH && stateDist[i] <= firstDist ? statePaths[i] : 0;
+        }
+        through[v] = 0;
+
+        for(k = 0; k <= last[v]; k++) {
+            int s = order[k];
+            if(s / numPhases == v) {
+                through[v] = saturatingAdd(through[v], saturatingMul(firstPaths[s], toEnd[s]));
+                continue;
+            }
+            if(stateDist[s] < firstDist) continue;
+
+            int nextPhase = (s % numPhases + 1) % numPhases;
+            for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
+                int t = i * numPhases + nextPhase;
+                if(onRoute[s][i]) firstPaths[t] = saturatingAdd(firstPaths[t], firstPaths[s]);
+            }
+        }
+    }
 }
 
 // *** Private Functions ***
 
 //check whether the given gameView is valid
 static void validGameView(GameView gameView) {
-    assert(gameView != NULL);
-    assert(gameView->g != NULL);
-    assert(gameView->isKilledLastTurn != NULL);
-    assert(gameView->health != NULL);
-    assert(gameView->trail_perPlayer != NULL);
+    CHECK(gameView != NULL);
+    CHECK_FULL(gameView->g != NULL);
+    CHECK_FULL(gameView->history != NULL);
+    CHECK_FULL(gameView->history->refs > 0);
+    CHECK_FULL(gameView->history->end >= numPlays(gameView));
+    CHECK_FULL(gameView->log != NULL && gameView->log->refs > 0);
+    CHECK_FULL(gameView->messages != NULL || gameView->numMessages == 0);
+}
+
+//Adds the player's latest move to the end of his history. A history
+//other views share is added to in place only if no view has gone past
+//this one in it (claiming the play with a compare-and-swap, so views on
+//other threads can't both have it); otherwise this view takes a copy
+static void appendMove(GameView gameView, PlayerID player, LocationID id) {
+    assert(gameView->numMoves[player] < GAME_START_SCORE);
+
+    //the play being added: the state has it already
+    int play = numPlays(gameView) - 1;
+    int expected = play;
+    History history = gameView->history;
+
+    if(history->refs == 1) {
+        history->end = play + 1;
+    } else if(atomic_compare_exchange_strong(&history->end, &expected, play + 1)) {
+        gameView->claimed++;
+    } else {
+        History shared = history;
+        unclaimPlays(gameView);
+        gameView->history = newHistory();
+        gameView->history->end = play + 1;
+
+        int i;
+        for(i = 0; i < NUM_PLAYERS; i++) {
+            memcpy(gameView->history->moves[i], shared->moves[i], gameView->numMoves[i] * sizeof(LocationID));
+        }
+        memcpy(gameView->history->dracLocations, shared->dracLocations,
+               gameView->numMoves[PLAYER_DRACULA] * sizeof(LocationID));
+        memcpy(gameView->history->timeline, shared->timeline, play * sizeof(TurnRecord));
+        releaseHistory(shared);
+    }
+
+    gameView->history->moves[player][gameView->numMoves[player]++] = id;
+}
+
+//Whether a snapshot (which may have come from anywhere) is one of this
+//version that restoreGameView() can safely make a view from: every field
+//in range, and the moves, timeline and state agreeing with each other
+static int validSnapshot(const Snapshot *snapshot) {
+    if(snapshot->magic != SNAPSHOT_MAGIC || snapshot->version != SNAPSHOT_VERSION) return FALSE;
+
+    const GameState *state = &snapshot->state;
+    if(!checkGameState(state)) return FALSE;
+
+    //each player has made a move in every round so far, and those before him in this one
+    int turn = stateRound(state) * NUM_PLAYERS + stateCurrentPlayer(state);
+    PlayerID p;
+    for(p = 0; p < NUM_PLAYERS; p++) {
+        int numMoves = turn / NUM_PLAYERS + (p < turn % NUM_PLAYERS);
+        if(snapshot->numMoves[p] != numMoves) return FALSE;
+
+        int j;
+        for(j = 0; j < numMoves; j++) {
+            if(!validMove(snapshot->moves[p][j])) return FALSE;
+        }
+        //a hunter is where he last moved, unless he's been sent to hospital
+        //(Dracula's latest move is checked with his trail below)
+        LocationID latest = numMoves > 0 ? snapshot->moves[p][numMoves - 1] : UNKNOWN_LOCATION;
+        LocationID where = stateLocation(state, p);
+        if(p != PLAYER_DRACULA && where != latest && where != ST_JOSEPH_AND_ST_MARYS) return FALSE;
+
+        //hunters' encounters and hospital visits; Dracula's minions
+        int actionBits = p == PLAYER_DRACULA ? (1 << (3 * ACTION_BITS)) - 1
+                                             : ((1 << (4 * ACTION_BITS)) - 1) | ACTION_HOSPITAL;
+        for(j = 0; j < numMoves; j++) {
+            if(snapshot->actions[p][j] & ~actionBits) return FALSE;
+        }
+    }
+
+    //where Dracula's moves took him, and his trail in the state
+    int numDracMoves = snapshot->numMoves[PLAYER_DRACULA];
+    int j;
+    for(j = 0; j < numDracMoves; j++) {
+        LocationID where = snapshot->dracLocations[j];
+        if(where != UNKNOWN_LOCATION && !validPlace(where) &&
+           where != CITY_UNKNOWN && where != SEA_UNKNOWN) return FALSE;
+    }
+    LocationID trail[TRAIL_SIZE], trailLocations[TRAIL_SIZE];
+    stateDraculaTrail(state, trail);
+    stateDraculaLocations(state, trailLocations);
+    for(j = 0; j < TRAIL_SIZE; j++) {
+        int n = numDracMoves - 1 - j;
+        if(trail[j] != (n >= 0 ? snapshot->moves[PLAYER_DRACULA][n] : UNKNOWN_LOCATION)) return FALSE;
+        if(trailLocations[j] != (n >= 0 ? snapshot->dracLocations[n] : UNKNOWN_LOCATION)) return FALSE;
+    }
+
+    //the score and health after each play, the last as the state has them
+    int k;
+    for(k = 0; k < turn; k++) {
+        const TurnRecord *record = &snapshot->timeline[k];
+        if(record->score > GAME_START_SCORE) return FALSE;
+        for(p = PLAYER_LORD_GODALMING; p < PLAYER_DRACULA; p++) {
+            int health = (record->hunterHealth >> (HUNTER_HEALTH_BITS * p)) & ((1 << HUNTER_HEALTH_BITS) - 1);
+            if(health > GAME_START_HUNTER_LIFE_POINTS) return FALSE;
+            if(k == turn - 1 && health != stateHealth(state, p)) return FALSE;
+        }
+    }
+    if(turn > 0) {
+        const TurnRecord *last = &snapshot->timeline[turn - 1];
+        if(last->score != stateScore(state) || last->dracHealth != stateHealth(state, PLAYER_DRACULA)) return FALSE;
+    }
+
+    return TRUE;
+}
+
+//Makes an empty history held by one view
+static History newHistory(void) {
+    History history = malloc(sizeof(struct history));
+    assert(history != NULL);
+    history->refs = 1;
+    history->end = 0;
+    return history;
+}
+
+//Gives back the plays the view added in place to a shared history, so
+//that the next view to play from where it came from can add in place too
+static void unclaimPlays(GameView gameView) {
+    int claimed = gameView->claimed;
+    if(claimed == 0) return;
+
+    //the plays in its history (its state may be a play ahead, in appendMove())
+    int end = 0;
+    PlayerID p;
+    for(p = 0; p < NUM_PLAYERS; p++) end += gameView->numMoves[p];
+    atomic_compare_exchange_strong(&gameView->history->end, &end, end - claimed);
+    gameView->claimed = 0;
+}
+
+//Lets go of a history, freeing it if no other view holds it
+static void releaseHistory(History history) {
+    assert(history != NULL && history->refs > 0);
+    if(--history->refs == 0) free(history);
+}
+
+//Makes an empty event log held by one view
+static EventLog newEventLog(void) {
+    EventLog log = malloc(sizeof(struct eventLog));
+    assert(log != NULL);
+    log->refs = 1;
+    log->events = NULL;
+    log->byType = NULL;
+    log->numEvents = 0;
+    log->maxEvents = 0;
 
     int i;
-    for(i = 0; i < NUM_PLAYERS; i++) assert(gameView->trail_perPlayer[i] != NULL);
+    for(i = 0; i < NUM_EVENT_TYPES; i++) log->numOfType[i] = 0;
+    return log;
+}
+
+//Lets go of an event log, freeing it if no other view holds it
+static void releaseEventLog(EventLog log) {
+    assert(log != NULL && log->refs > 0);
+    if(--log->refs > 0) return;
 
+    free(log->events);
+    free(log->byType);
+    free(log);
 }
 
-// Returns Id of current player
-static PlayerID whichPlayer(char c) {
-    PlayerID id;   
+//Makes room for maxEvents events (byType has that much room for each type)
+static void growEvents(EventLog log, int maxEvents) {
+    if(maxEvents <= log->maxEvents) return;
+
+    log->events = realloc(log->events, maxEvents * sizeof(Event));
+    assert(log->events != NULL);
+
+    int *byType = malloc(NUM_EVENT_TYPES * maxEvents * sizeof(int));
+    assert(byType != NULL);
 
-    switch(c) {
-    case 'G': id = PLAYER_LORD_GODALMING; break;
-    case 'S': id = PLAYER_DR_SEWARD; break;
-    case 'H': id = PLAYER_VAN_HELSING; break;
-    case 'M': id = PLAYER_MINA_HARKER; break;
-    case 'D': id = PLAYER_DRACULA; break;
-    default: id = -1; break;
+    int i;
+    for(i = 0; i < NUM_EVENT_TYPES && log->maxEvents > 0; i++) {
+        memcpy(&byType[i * maxEvents], &log->byType[i * log->maxEvents],
+               log->numOfType[i] * sizeof(int));
     }
+    free(log->byType);
 
-    assert(id >= PLAYER_LORD_GODALMING && id <= PLAYER_DRACULA);
-    return id;
+    log->byType = byType;
+    log->maxEvents = maxEvents;
 }
 
+//Adds the events of the player's latest play to the log
+static void recordEvents(GameView gameView, PlayerID player, int actions) {
+    History history = gameView->history;
+    Round round = gameView->numMoves[player] - 1;
+    int mask = (1 << ACTION_BITS) - 1;
+
+    if(player != PLAYER_DRACULA) {
+        //encounters, in order, up to the first '.'
+        LocationID where = history->moves[player][round];
+        int j;
+        for(j = 0; j < 4; j++) {
+            int action = (actions >> (ACTION_BITS * j)) & mask;
+            if(action == ACTION_NONE) break;
+
+            int type = action == ACTION_TRAP ? EVENT_TRAP :
+                       action == ACTION_VAMPIRE ? EVENT_VAMPIRE_KILLED : EVENT_DRACULA;
+            addEvent(gameView, type, round, player, where);
+        }
+        if(actions & ACTION_HOSPITAL) addEvent(gameView, EVENT_HOSPITAL, round, player, where);
+        return;
+    }
 
-// Inserts current location to trail accordingly 
-static void frontInsert(LocationID **trail_perPlayer, PlayerID player, char *location) {
-    assert(trail_perPlayer != NULL);
-    assert(trail_perPlayer[player] != NULL);
-    assert(location != NULL);    
+    //Dracula places minions where he is; the move leaving his trail takes its own
+    LocationID where = history->dracLocations[round];
+    LocationID left = round >= TRAIL_SIZE ? history->dracLocations[round - TRAIL_SIZE] : UNKNOWN_LOCATION;
+    int leaving = (actions >> (2 * ACTION_BITS)) & mask;
 
-    char *db[5] = {"D1", "D2", "D3", "D4", "D5"};
-   
-    LocationID id = UNKNOWN_LOCATION;
-   
-    if(strcmp(location, "C?") == 0) {
-        id = CITY_UNKNOWN;
-    } else if(strcmp(location, "S?") == 0) {
-        id = SEA_UNKNOWN;
-    } else if(strcmp(location, "HI") == 0) {
-        id = HIDE;
-    } else if(strcmp(location, "TP") == 0) {
-        id = TELEPORT;
-    } else {
-       int i;
-       for(i = 1; i <= 5; i++) {
-           if(strcmp(location, db[i-1]) == 0) break;
-       }
-
-       if(i == 1) {
-           id = DOUBLE_BACK_1;
-       } else if(i == 2) {
-           id = DOUBLE_BACK_2;
-       } else if(i == 3) {
-           id = DOUBLE_BACK_3;
-       } else if(i == 4) {
-           id = DOUBLE_BACK_4;
-       } else if(i == 5) {
-           id = DOUBLE_BACK_5;
-       } else {
-           id = abbrevToID(location);
-       }
+    if(((actions >> 0) & mask) == ACTION_TRAP) addEvent(gameView, EVENT_TRAP_PLACED, round, player, where);
+    if(((actions >> ACTION_BITS) & mask) == ACTION_VAMPIRE) addEvent(gameView, EVENT_VAMPIRE_PLACED, round, player, where);
+    if(leaving == ACTION_OTHER) addEvent(gameView, EVENT_TRAP_MALFUNCTION, round, player, left);
+    if(leaving == ACTION_VAMPIRE) addEvent(gameView, EVENT_VAMPIRE_MATURED, round, player, left);
+}
+
+//Appends an event to the log and the index for its type,
+//first taking a copy of the log if other views share it
+static void addEvent(GameView gameView, int type, Round round, PlayerID player, LocationID where) {
+    EventLog log = gameView->log;
+
+    if(log->refs > 1) {
+        EventLog shared = log;
+        log = gameView->log = newEventLog();
+        growEvents(log, shared->maxEvents > 0 ? shared->maxEvents : MIN_EVENTS);
+
+        int i;
+        for(i = 0; i < NUM_EVENT_TYPES && shared->maxEvents > 0; i++) {
+            log->numOfType[i] = shared->numOfType[i];
+            memcpy(&log->byType[i * log->maxEvents], &shared->byType[i * shared->maxEvents],
+                   shared->numOfType[i] * sizeof(int));
+        }
+        if(shared->maxEvents > 0) memcpy(log->events, shared->events, shared->numEvents * sizeof(Event));
+        log->numEvents = shared->numEvents;
+        releaseEventLog(shared);
+    }
+
+    if(log->numEvents == log->maxEvents) {
+        growEvents(log, log->maxEvents == 0 ? MIN_EVENTS : 2 * log->maxEvents);
     }
 
-    assert((id >= UNKNOWN_LOCATION && id <= MAX_MAP_LOCATION) || (id >= CITY_UNKNOWN && id <= TELEPORT));
+    Event *e = &log->events[log->numEvents];
+    e->round = round;
+    e->player = player;
+    e->type = type;
+    e->location = where;
 
-    int j;
-    for(j = GAME_START_SCORE - 1; j > 0; j--) {
-        trail_perPlayer[player][j] = trail_perPlayer[player][j-1];
+    log->byType[type * log->maxEvents + log->numOfType[type]++] = log->numEvents++;
+}
+
+//How many plays the view has seen
+static int numPlays(GameView gameView) {
+    return stateRound(&gameView->state) * NUM_PLAYERS + stateCurrentPlayer(&gameView->state);
+}
+
+//Notes the score and health after the latest play
+static void recordTurn(GameView gameView) {
+    TurnRecord *record = &gameView->history->timeline[numPlays(gameView) - 1];
+    record->score = stateScore(&gameView->state);
+    record->dracHealth = stateHealth(&gameView->state, PLAYER_DRACULA);
+    record->hunterHealth = 0;
+
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p < PLAYER_DRACULA; p++) {
+        record->hunterHealth |= stateHealth(&gameView->state, p) << (HUNTER_HEALTH_BITS * p);
     }
+}
 
-    trail_perPlayer[player][j] = id;
+//Returns the player's move from 'back' turns ago (0 = the latest),
+//or UNKNOWN_LOCATION if he has not moved that many times
+static LocationID recentMove(GameView gameView, PlayerID player, int back) {
+    CHECK_FULL(back >= 0);
+
+    int n = gameView->numMoves[player];
+    if(back >= n) return UNKNOWN_LOCATION;
+    return gameView->history->moves[player][n - 1 - back];
 }
 
 // Finds the rail connected cities according to the railMoves
 static void railConnection(GameView gameView, int *reachable, LocationID from, int railMoves) {
     validGameView(gameView);
-    assert(reachable != NULL);
-    assert(from >= MIN_MAP_LOCATION && from <= MAX_MAP_LOCATION);
-    assert(railMoves > 1);
-
-    // how many rounds it needs to be checked
-    int roundCheck = railMoves - 1;
-    Queue *qList = malloc(roundCheck * sizeof(Queue *)); //An array of Queue ADT
-    assert(qList != NULL);
+    CHECK_FULL(reachable != NULL);
+    CHECK_FULL(from >= MIN_MAP_LOCATION && from <= MAX_MAP_LOCATION);
+    CHECK_FULL(railMoves > 1);
 
+    // how many stops away each location is (NO_PATH = not reached yet)
     int i;
-    for(i = 0; i < roundCheck; i++) {
-        qList[i] = newQueue();
-        assert(qList[i] != NULL);
-    }
-   
-    //Finds all the adjacent cities connected by rails in the current city
-    VList curr = gameView->g->connections[from];
-    while(curr != NULL) {
-        if(curr->type == RAIL) {
-            reachable[curr->v] = 1;    
-            enterQueue(qList[0], curr->v); 
-        }
-
-        curr = curr->next;
-    }    
+    int stops[NUM_MAP_LOCATIONS];
+    for(i = 0; i < NUM_MAP_LOCATIONS; i++) stops[i] = NO_PATH;
+    stops[from] = 0; 
 
-    //tells which locations have been visited
-    int *visited = malloc(NUM_MAP_LOCATIONS * sizeof(int));
-    assert(visited != NULL);
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) visited[i] = 0;
-    visited[from] = 1; 
+    LocationID storage[QUEUE_WORDS(NUM_MAP_LOCATIONS)];
+    Queue q = queueIn(storage, NUM_MAP_LOCATIONS);
+    enterQueue(q, from);
 
-   
-    //BFS x 1 or BFS x 2 (depending on the number of railMoves can be made)
-    for(i = 0; i < roundCheck; i++) {
-        while(!emptyQueue(qList[i])) {
-            LocationID s = leaveQueue(qList[i]);
-            assert(from >= MIN_MAP_LOCATION && from <= MAX_MAP_LOCATION);
- 
-            if(visited[s] == 1) continue;
-            visited[s] = 1;
-
-            curr = gameView->g->connections[s];
-            while(curr != NULL) {
-                if(curr->type == RAIL) {
-                    reachable[curr->v] = 1;
+    //BFS along the rails, up to railMoves stops away
+    while(!emptyQueue(q)) {
+        LocationID s = leaveQueue(q);
+        if(stops[s] == railMoves) continue;
 
-                    if(!visited[curr->v] && i+1 < roundCheck) enterQueue(qList[i+1], curr->v);
-                }
-            
-                curr = curr->next;
+        VList curr = gameView->g->connections[s];
+        while(curr != NULL) {
+            if(curr->type == RAIL && stops[curr->v] == NO_PATH) {
+                reachable[curr->v] = 1;
+                stops[curr->v] = stops[s] + 1;
+                enterQueue(q, curr->v);
             }
+            
+            curr = curr->next;
         }
     }
-
-    for(i = 0; i < roundCheck; i++) {
-        assert(qList[i] != NULL);
-        disposeQueue(qList[i]);
-    }
-
-    free(qList);
-    free(visited);
 }
 
+// Adds two path counts, sticking at MAX_PATH_COUNT instead of overflowing
+static int saturatingAdd(int a, int b) {
+    CHECK_FULL(a >= 0 && b >= 0);
+    if(a > MAX_PATH_COUNT - b) return MAX_PATH_COUNT;
+    return a + b;
+}
 
+// Multiplies two path counts, sticking at MAX_PATH_COUNT instead of overflowing
+static int saturatingMul(int a, int b) {
+    CHECK_FULL(a >= 0 && b >= 0);
+    if(a != 0 && b > MAX_PATH_COUNT / a) return MAX_PATH_COUNT;
+    return a * b;
+}
@@ -8,6 +8,7 @@
 #include "Globals.h"
 #include "Game.h"
 #include "Places.h"
+#include "GameState.h"
 
 typedef struct gameView *GameView;
 
@@ -24,9 +25,81 @@ typedef struct gameView *GameView;
 //
 // The "PlayerMessage" type is defined in game.h.
 // You are free to ignore messages if you wish.
+//
+// The messages are not copied: the view reads them from the given array
+// when getMessage() asks for one, so the array must outlive the view (and
+// any clones of it). messages may be NULL if nothing is going to ask.
 
 GameView newGameView(char *pastPlays, PlayerMessage messages[]);
 
+// Each play in pastPlays is PLAY_LENGTH chars (see GameState.h)
+
+// applyPlays() brings the GameView up to date with plays made since it was
+// created (or last updated), without going over the earlier plays again.
+//
+// newPlays is in the same format as pastPlays; a leading space is allowed,
+// so it can be the rest of a longer pastPlays string.
+
+void applyPlays(GameView currentView, const char *newPlays);
+
+// applyPlaysLength() is applyPlays() for plays that need not be followed
+// by a '\0' (say, inside a file read into memory): only the first 'length'
+// chars of newPlays are read.
+
+void applyPlaysLength(GameView currentView, const char *newPlays, int length);
+
+
+// cloneGameView() makes a copy of the GameView that can be taken in a
+// different direction with applyPlays(); the copy shares the map and the
+// history with the original rather than copying them, so it is cheap.
+// Both must be disposed of.
+//
+// Different views (clones included) can be used from different threads
+// at once, and so can one view that nothing is changing: the parts
+// clones share are counted atomically and only copied, never changed,
+// while shared (a clone's new moves go past the end of a shared history
+// only once it has claimed that end atomically; no other view reads
+// there). A view that is being changed belongs to one thread.
+
+GameView cloneGameView(GameView original);
+
+
+// A Snapshot is a GameView laid out flat, so that it can be stored (say
+// one for every round of a game) and brought back with a single read or
+// an mmap instead of parsing the plays again. It is in the machine's own
+// byte order; the magic number and version catch anything else.
+
+#define SNAPSHOT_MAGIC   0x56474446     // "FDGV" read as bytes
+#define SNAPSHOT_VERSION 4
+
+// The score and everyone's health after a play (see getScoreAfter())
+#define HUNTER_HEALTH_BITS 4
+
+typedef struct turnRecord {
+    short score;
+    short dracHealth;
+    unsigned short hunterHealth;        // HUNTER_HEALTH_BITS each, Lord Godalming's lowest
+} TurnRecord;
+
+typedef struct snapshot {
+    unsigned int magic;
+    unsigned int version;
+    GameState state;
+    short numMoves[NUM_PLAYERS];
+    signed char moves[NUM_PLAYERS][GAME_START_SCORE];   // each player's moves, oldest first
+    signed char dracLocations[GAME_START_SCORE];        // where Dracula's moves took him
+    unsigned short actions[NUM_PLAYERS][GAME_START_SCORE];  // the events of each play
+    TurnRecord timeline[NUM_PLAYERS * GAME_START_SCORE];    // after each play
+} Snapshot;
+
+// takeSnapshot() fills in a Snapshot of the GameView as it is now.
+// restoreGameView() makes a new GameView from one, or returns NULL if it
+// is not a Snapshot of this version, or has any field out of range or
+// not agreeing with the rest (so one read from anywhere is safe to try).
+
+void takeSnapshot(GameView currentView, Snapshot *snapshot);
+GameView restoreGameView(const Snapshot *snapshot);
+
 
 // disposeGameView() frees all memory previously allocated for the GameView
 // toBeDeleted. toBeDeleted should not be accessed after the call.
@@ -104,6 +177,98 @@ LocationID getLocation(GameView currentView, PlayerID player);
 void getHistory(GameView currentView, PlayerID player,
                  LocationID trail[TRAIL_SIZE]);
 
+// getLocationHistory() is getHistory() with Dracula's HIDE, DOUBLE_BACK_N
+//   and TELEPORT moves replaced by where they took him
+// If that was an unknown city or sea, it is CITY_UNKNOWN or SEA_UNKNOWN
+
+void getLocationHistory(GameView currentView, PlayerID player,
+                        LocationID trail[TRAIL_SIZE]);
+
+// getMinions() finds the number of traps and immature vampires known to be
+//   at the given location
+// Counts are exact when every one of Dracula's moves is known (his own view);
+//   minions placed in unknown cities are not counted
+
+void getMinions(GameView currentView, LocationID where,
+                int *numTraps, int *numVamps);
+
+// getMoves() gives the player's whole history, oldest first, setting
+//   *numMoves to its length; the move made in round r is at index r
+// getLocations() is the same with Dracula's special moves replaced by
+//   where they took him, as in getLocationHistory()
+// getMoveInRound() and getLocationInRound() point at round r's entry in
+//   those arrays, or are NULL if the player has not moved in round r yet
+// None of these copy anything: the arrays belong to the GameView and may
+//   change or go once it is updated or disposed of
+
+const LocationID *getMoves(GameView currentView, PlayerID player, int *numMoves);
+const LocationID *getLocations(GameView currentView, PlayerID player, int *numMoves);
+const LocationID *getMoveInRound(GameView currentView, PlayerID player, Round round);
+const LocationID *getLocationInRound(GameView currentView, PlayerID player, Round round);
+
+// Every encounter, hospital visit and minion placed, left or matured is
+//   kept as an Event, in the order they happened
+// An event's location is where the player was, as far as is known; trap
+//   malfunctions and vampires maturing are where Dracula was when he placed them
+
+#define EVENT_TRAP              0   // a hunter set off a trap
+#define EVENT_VAMPIRE_KILLED    1   // a hunter killed an immature vampire
+#define EVENT_DRACULA           2   // a hunter confronted Dracula
+#define EVENT_HOSPITAL          3   // a hunter lost all his health
+#define EVENT_TRAP_PLACED       4
+#define EVENT_VAMPIRE_PLACED    5
+#define EVENT_TRAP_MALFUNCTION  6   // a trap left Dracula's trail unsprung
+#define EVENT_VAMPIRE_MATURED   7
+#define NUM_EVENT_TYPES         8
+
+typedef struct event {
+    short round;
+    signed char player;
+    signed char type;
+    short location;
+} Event;
+
+// getEvents() points at all the events so far, setting *numEvents
+// numEventsOfType() counts the events of one type, and getEventOfType()
+//   points at the k'th of them (0 is the earliest), or is NULL
+// lastEventBefore() points at the latest event of the type in an earlier
+//   round than the given one, or is NULL (a binary search)
+// As with getMoves(), nothing is copied: the events belong to the GameView
+
+const Event *getEvents(GameView currentView, int *numEvents);
+int numEventsOfType(GameView currentView, int type);
+const Event *getEventOfType(GameView currentView, int type, int k);
+const Event *lastEventBefore(GameView currentView, int type, Round round);
+
+// getScoreAfter() and getHealthAfter() give the score and a player's
+//   health as getScore() and getHealth() would have given after the first
+//   given number of plays (0 is the start of the game)
+
+int getScoreAfter(GameView currentView, int plays);
+int getHealthAfter(GameView currentView, PlayerID player, int plays);
+
+// getMessage() gives the message left with a play (0 is the first play),
+//   or "" for plays the view was given no message for: plays applied
+//   after it was created, or every play if it was created without messages
+
+const char *getMessage(GameView currentView, int play);
+
+// A ViewState is everything the accessors above give about the present,
+// filled in by one call, for AI code that asks the same questions over
+// and over: read the fields rather than calling the accessors in a loop.
+// It is a copy, so it does not change if the view does.
+typedef struct viewState {
+    Round round;
+    PlayerID currentPlayer;
+    int score;
+    int health[NUM_PLAYERS];
+    LocationID location[NUM_PLAYERS];           // as getLocation() gives it
+    LocationID moves[NUM_PLAYERS][TRAIL_SIZE];  // as getHistory() gives them
+    LocationID trail[NUM_PLAYERS][TRAIL_SIZE];  // as getLocationHistory() gives it
+} ViewState;
+
+void getViewState(GameView currentView, ViewState *state);
+
 
 //// Functions that query the map to find information about connectivity
 
@@ -122,4 +287,32 @@ LocationID *connectedLocations(GameView currentView, int *numLocations,
                                LocationID from, PlayerID player, Round round,
                                int road, int rail, int sea);
 
+// reachableFrom() is connectedLocations() without the allocation:
+//   it sets reachable[v] to 1 for every location v in that array and
+//   to 0 everywhere else ('from' must be a real location)
+// Only (round + player) % 4 matters for the rail allowance
+
+void reachableFrom(GameView currentView, int reachable[NUM_MAP_LOCATIONS], LocationID from, PlayerID player,
+                   Round round, int road, int rail, int sea);
+
+// pathCounts() runs one breadth-first search from 'from' for the given player,
+//   making the first move in the given round (rail allowance is worked out
+//   for each round along the way)
+// A route is a sequence of moves to a different location each turn
+// dist[v] is the number of moves needed to reach v, or NO_PATH
+// numPaths[v] is the number of distinct shortest routes from 'from' to v
+// If through is not NULL and 'to' is reachable, through[v] is the number of
+//   shortest routes from 'from' to 'to' that pass through v, each counted
+//   once even if it comes back to v (so through[from] == through[to] ==
+//   the total number of shortest routes)
+// All counts stop at MAX_PATH_COUNT rather than overflowing
+
+#define NO_PATH         -1
+#define MAX_PATH_COUNT  2147483647
+#define NUM_RAIL_PHASES 4
+
+void pathCounts(GameView currentView, LocationID from, LocationID to, PlayerID player, Round round,
+                int road, int rail, int sea, int dist[NUM_MAP_LOCATIONS],
+                int numPaths[NUM_MAP_LOCATIONS], int through[NUM_MAP_LOCATIONS]);
+
 #endif
@@ -6,9 +6,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <assert.h>
 #include <string.h>
 #include "Globals.h"
+#include "Check.h"
 #include "Game.h"
 #include "GameView.h"
 #include "HunterView.h"
@@ -29,6 +31,7 @@ struct MapRep {
    int   nV;         // #vertices
    int   nE;         // #edges
    VList connections[NUM_MAP_LOCATIONS]; // array of lists
+   atomic_int refs;  // #holders sharing it
 };
 
 
@@ -38,13 +41,14 @@ struct hunterView {
 
 //Private Functions
 static void validHunterView(HunterView hunterView);
+static void reachableBackwards(HunterView hunterView, int *reachable, LocationID to, PlayerID player,
+                               int phase, int road, int rail, int sea);
 
 
 // Creates a new HunterView to summarise the current state of the game
 HunterView newHunterView(char *pastPlays, PlayerMessage messages[])
 {
     assert(pastPlays != NULL);
-    assert(messages != NULL);
 
     // Initialise the HunterView ADT
     HunterView hunterView = malloc(sizeof(struct hunterView));
@@ -56,6 +60,29 @@ HunterView newHunterView(char *pastPlays, PlayerMessage messages[])
 }
      
      
+// Updates the HunterView with plays made since it was created or last updated
+void updateHunterView(HunterView currentView, const char *newPlays)
+{
+    validHunterView(currentView);
+    assert(newPlays != NULL);
+
+    applyPlays(currentView->gameView, newPlays);
+}
+
+
+// Copies the HunterView cheaply, to try out plays on
+HunterView cloneHunterView(HunterView original)
+{
+    validHunterView(original);
+
+    HunterView clone = malloc(sizeof(struct hunterView));
+    assert(clone != NULL);
+    clone->gameView = cloneGameView(original->gameView);
+
+    return clone;
+}
+
+
 // Frees all memory previously allocated for the HunterView toBeDeleted
 void disposeHunterView(HunterView toBeDeleted)
 {
@@ -93,7 +120,7 @@ int giveMeTheScore(HunterView currentView)
 int howHealthyIs(HunterView currentView, PlayerID player)
 {
     validHunterView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
     return getHealth(currentView->gameView, player);
 }
 
@@ -101,7 +128,7 @@ int howHealthyIs(HunterView currentView, PlayerID player)
 LocationID whereIs(HunterView currentView, PlayerID player)
 {
     validHunterView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
     return getLocation(currentView->gameView, player);
 }
 
@@ -112,10 +139,35 @@ void giveMeTheTrail(HunterView currentView, PlayerID player,
                             LocationID trail[TRAIL_SIZE])
 {
     validHunterView(currentView);
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA); 
     getHistory(currentView->gameView, player, trail);   
 }
 
+// Points at all of the player's moves, oldest first (no copy)
+const LocationID *giveMeTheWholeTrail(HunterView currentView, PlayerID player, int *numMoves)
+{
+    validHunterView(currentView);
+    return getMoves(currentView->gameView, player, numMoves);
+}
+
+// The message left with a play (no copy)
+const char *giveMeTheMessage(HunterView currentView, int play)
+{
+    validHunterView(currentView);
+    return getMessage(currentView->gameView, play);
+}
+
+// Everything about the present in one go (see giveMeTheState in HunterView.h)
+void giveMeTheState(HunterView currentView, ViewState *state)
+{
+    validHunterView(currentView);
+    CHECK(state != NULL);
+    getViewState(currentView->gameView, state);
+
+    // giveMeTheTrail() gives the moves as they were made
+    memcpy(state->trail, state->moves, sizeof(state->trail));
+}
+
 //// Functions that query the map to find information about connectivity
 
 // What are my possible next moves (locations)
@@ -124,7 +176,7 @@ LocationID *whereCanIgo(HunterView currentView, int *numLocations,
 {
     validHunterView(currentView);
     PlayerID player = getCurrentPlayer(currentView->gameView);
-    assert(player != PLAYER_DRACULA);
+    CHECK(player != PLAYER_DRACULA);
     LocationID from = getLocation(currentView->gameView, player);
     Round round = getRound(currentView->gameView);
 
@@ -143,8 +195,8 @@ LocationID *whereCanTheyGo(HunterView currentView, int *numLocations,
                            PlayerID player, int road, int rail, int sea)
 {
     validHunterView(currentView);  
-    assert(numLocations != NULL);   // check that there are locations to visit
-    assert(player >= PLAYER_LORD_GODALMING && player <= PLAYER_MINA_HARKER);
+    CHECK(numLocations != NULL);   // check that there are locations to visit
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_MINA_HARKER);
 
     // need to find out the current location of the player
     LocationID there = whereIs(currentView, player);
@@ -174,7 +226,7 @@ LocationID *shortestPath(HunterView currentView, int *length, PlayerID player, L
                          int road, int rail, int sea) 
 {
     validHunterView(currentView);
-    assert(length != NULL);
+    CHECK(length != NULL);
 
     if(start < MIN_MAP_LOCATION || start > MAX_MAP_LOCATION) {
         *length = 0;
@@ -195,65 +247,41 @@ LocationID *shortestPath(HunterView currentView, int *length, PlayerID player, L
     }
    
     int i = 0;
-    int cost = 1;
-    int maxCost = 99999999;
     int dist[NUM_MAP_LOCATIONS], pred[NUM_MAP_LOCATIONS];
-    int visited[NUM_MAP_LOCATIONS];
 
     for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        dist[i] = maxCost;
+        dist[i] = NO_PATH;
         pred[i] = UNKNOWN_LOCATION;
-        visited[i] = 0;
     }
     dist[start] = 0;
     pred[start] = start;
 
 
-    Queue *qList = malloc(NUM_MAP_LOCATIONS * sizeof(Queue));
-    assert(qList != NULL);
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        qList[i] = newQueue();
-        assert(qList[i] != NULL);
-    }
-    enterQueue(qList[0], start);
+    LocationID storage[QUEUE_WORDS(NUM_MAP_LOCATIONS)];
+    Queue q = queueIn(storage, NUM_MAP_LOCATIONS);
+    enterQueue(q, start);
 
 
     Round round = giveMeTheRound(currentView);
 
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        while(!emptyQueue(qList[i])) {
-            LocationID s = leaveQueue(qList[i]);
-
-            if(visited[s]) continue;
-            visited[s] = 1;
-
-            int numLocations = 0;
-            LocationID *connLoc = connectedLocations(currentView->gameView, &numLocations,
-                                                     s, player, round + i, road, rail, sea);
-            assert(connLoc != NULL);
-             
-            int j = 0;
-            for(j = 0; j < numLocations; j++) {
-                if(i + 1 < NUM_MAP_LOCATIONS) {
-                    enterQueue(qList[i+1], connLoc[j]);
-                }
+    while(!emptyQueue(q)) {
+        LocationID s = leaveQueue(q);
+        if(s == end) break;
 
-                if(dist[s] + cost < dist[connLoc[j]]) {
-                    dist[connLoc[j]] = dist[s] + cost;
-                    pred[connLoc[j]] = s;
-                }
-            }
+        // the rail allowance depends on the round this move is made in
+        int reachable[NUM_MAP_LOCATIONS];
+        reachableFrom(currentView->gameView, reachable, s, player, round + dist[s], road, rail, sea);
 
-            free(connLoc);
+        LocationID v;
+        for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+            if(!reachable[v] || dist[v] != NO_PATH) continue;
+
+            dist[v] = dist[s] + 1;
+            pred[v] = s;
+            enterQueue(q, v);
         }
     }    
 
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
-        assert(qList[i] != NULL);
-        disposeQueue(qList[i]);
-    }
-    free(qList);
-
     if(pred[end] == UNKNOWN_LOCATION) {
         *length = 0;
         return NULL;
@@ -279,12 +307,207 @@ LocationID *shortestPath(HunterView currentView, int *length, PlayerID player, L
     return sPath;
 }
 
+// Bidirectional version of shortestPath: searches forwards from start and
+// backwards from end one layer at a time, and stops as soon as they meet
+LocationID *shortestPathBidir(HunterView currentView, int *length, PlayerID player, LocationID start, LocationID end,
+                              int road, int rail, int sea)
+{
+    validHunterView(currentView);
+    CHECK(length != NULL);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+
+    if(start < MIN_MAP_LOCATION || start > MAX_MAP_LOCATION) {
+        *length = 0;
+        return NULL;
+    }
+
+    if(end < MIN_MAP_LOCATION || end > MAX_MAP_LOCATION) {
+        *length = 0;
+        return NULL;
+    }
+
+    if(start == end) {
+        *length = 1;
+        LocationID *sPath = malloc(*length * sizeof(LocationID));
+        assert(sPath != NULL);
+        sPath[0] = start;
+        return sPath;
+    }
+
+    // Dracula can't get to the hospital at all
+    if(player == PLAYER_DRACULA && (start == ST_JOSEPH_AND_ST_MARYS || end == ST_JOSEPH_AND_ST_MARYS)) {
+        *length = 0;
+        return NULL;
+    }
+
+    // A search state is a location plus the rail phase of the next move from it.
+    // Going forwards the phase follows from the number of moves made so far.
+    // Going backwards the total length isn't known yet, so every phase is kept
+    // (state (v, q) = "end can be reached from v if the next move is in phase q")
+    int numPhases = (rail == TRUE && player != PLAYER_DRACULA) ? NUM_RAIL_PHASES : 1;
+    int numStates = NUM_MAP_LOCATIONS * numPhases;
+    Round round = giveMeTheRound(currentView);
+
+    int i, q;
+    int fSeen[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES], bSeen[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    LocationID pred[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES], succ[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    for(i = 0; i < numStates; i++) {
+        fSeen[i] = bSeen[i] = FALSE;
+        pred[i] = succ[i] = UNKNOWN_LOCATION;
+    }
+
+    // the newest layer on each side
+    int fFrontier[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES], bFrontier[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    int next[NUM_MAP_LOCATIONS * NUM_RAIL_PHASES];
+    int fSize = 0, bSize = 0, nSize = 0;
+
+    int fPhase = round % numPhases;  // phase of the next move out of the forward frontier
+    fSeen[start * numPhases + fPhase] = TRUE;
+    fFrontier[fSize++] = start * numPhases + fPhase;
+
+    for(q = 0; q < numPhases; q++) {
+        bSeen[end * numPhases + q] = TRUE;
+        bFrontier[bSize++] = end * numPhases + q;
+    }
+
+    int meet = -1;
+    int forwards = TRUE;
+    int reachable[NUM_MAP_LOCATIONS];
+
+    while(meet < 0 && fSize > 0 && bSize > 0) {
+        nSize = 0;
+
+        if(forwards) {
+            int nextPhase = (fPhase + 1) % numPhases;
+            for(i = 0; i < fSize; i++) {
+                LocationID s = fFrontier[i] / numPhases;
+                reachableFrom(currentView->gameView, reachable, s, player, fPhase, road, rail, sea);
+
+                LocationID v;
+                for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+                    int t = v * numPhases + nextPhase;
+                    if(!reachable[v] || v == s || fSeen[t]) continue;
+
+                    fSeen[t] = TRUE;
+                    pred[t] = s;
+                    next[nSize++] = t;
+                }
+            }
+
+            fPhase = nextPhase;
+            for(i = 0; i < nSize; i++) fFrontier[i] = next[i];
+            fSize = nSize;
+        } else {
+            for(i = 0; i < bSize; i++) {
+                LocationID s = bFrontier[i] / numPhases;
+                int phase = (bFrontier[i] % numPhases + numPhases - 1) % numPhases;
+                reachableBackwards(currentView, reachable, s, player, phase, road, rail, sea);
+
+                LocationID v;
+                for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+                    int t = v * numPhases + phase;
+                    if(!reachable[v] || v == s || bSeen[t]) continue;
+
+                    bSeen[t] = TRUE;
+                    succ[t] = s;
+                    next[nSize++] = t;
+                }
+            }
+
+            for(i = 0; i < nSize; i++) bFrontier[i] = next[i];
+            bSize = nSize;
+        }
+
+        // The frontiers meet at a state reached both ways with the same phase
+        for(i = 0; i < fSize && meet < 0; i++) {
+            if(bSeen[fFrontier[i]]) meet = fFrontier[i];
+        }
+        for(i = 0; i < bSize && meet < 0; i++) {
+            if(fSeen[bFrontier[i]]) meet = bFrontier[i];
+        }
+
+        forwards = !forwards;
+    }
+
+    if(meet < 0) {
+        *length = 0;
+        return NULL;
+    }
+
+    // Walk back to start, then on to end (phases step by one per move)
+    int count = 0;
+    int t = meet;
+    while(pred[t] != UNKNOWN_LOCATION) {
+        t = pred[t] * numPhases + (t % numPhases + numPhases - 1) % numPhases;
+        count++;
+    }
+    int meetIndex = count;
+    t = meet;
+    while(succ[t] != UNKNOWN_LOCATION) {
+        t = succ[t] * numPhases + (t % numPhases + 1) % numPhases;
+        count++;
+    }
+    *length = count + 1;
+
+    LocationID *sPath = malloc(*length * sizeof(LocationID));
+    assert(sPath != NULL);
+
+    t = meet;
+    for(i = meetIndex; i >= 0; i--) {
+        sPath[i] = t / numPhases;
+        if(i > 0) t = pred[t] * numPhases + (t % numPhases + numPhases - 1) % numPhases;
+    }
+    t = meet;
+    for(i = meetIndex + 1; i < *length; i++) {
+        t = succ[t] * numPhases + (t % numPhases + 1) % numPhases;
+        sPath[i] = t / numPhases;
+    }
+
+    CHECK_FULL(sPath[0] == start && sPath[*length - 1] == end);
+    return sPath;
+}
+
+// Counts the shortest routes from start to end and how many go through each location
+int shortestPathCounts(HunterView currentView, PlayerID player, LocationID start, LocationID end,
+                       int road, int rail, int sea, int dist[NUM_MAP_LOCATIONS],
+                       int through[NUM_MAP_LOCATIONS])
+{
+    validHunterView(currentView);
+    CHECK(player >= PLAYER_LORD_GODALMING && player <= PLAYER_DRACULA);
+    CHECK(dist != NULL && through != NULL);
+    CHECK(start >= MIN_MAP_LOCATION && start <= MAX_MAP_LOCATION);
+    CHECK(end >= MIN_MAP_LOCATION && end <= MAX_MAP_LOCATION);
+
+    int numPaths[NUM_MAP_LOCATIONS];
+    pathCounts(currentView->gameView, start, end, player, giveMeTheRound(currentView),
+               road, rail, sea, dist, numPaths, through);
+
+    return numPaths[end];
+}
+
 
 // *** Private Functions ***
 
 //check whether the given hunterView is valid
 static void validHunterView(HunterView hunterView) {
-    assert(hunterView != NULL);
-    assert(hunterView->gameView != NULL);
+    CHECK(hunterView != NULL);
+    CHECK_FULL(hunterView->gameView != NULL);
 }
 
+// Finds the locations from which 'to' can be reached in one move made in
+// the given rail phase; every connection (and every rail journey) can be
+// travelled both ways, so this is the forward set turned around
+static void reachableBackwards(HunterView hunterView, int *reachable, LocationID to, PlayerID player,
+                               int phase, int road, int rail, int sea) {
+    CHECK_FULL(reachable != NULL);
+
+    // Dracula never starts a move in the hospital
+    if(player == PLAYER_DRACULA && to == ST_JOSEPH_AND_ST_MARYS) {
+        int i;
+        for(i = 0; i < NUM_MAP_LOCATIONS; i++) reachable[i] = 0;
+        return;
+    }
+
+    reachableFrom(hunterView->gameView, reachable, to, player, phase, road, rail, sea);
+    if(player == PLAYER_DRACULA) reachable[ST_JOSEPH_AND_ST_MARYS] = 0;
+}
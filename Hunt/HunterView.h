@@ -8,6 +8,7 @@
 #include "Globals.h"
 #include "Game.h"
 #include "Places.h"
+#include "GameView.h"
 
 typedef struct hunterView *HunterView;
 
@@ -28,10 +29,24 @@ typedef struct hunterView *HunterView;
 //
 // The "PlayerMessage" type is defined in Game.h.
 // You are free to ignore messages if you wish.
+//
+// The messages are not copied (see newGameView()): pass NULL to skip them.
 
 HunterView newHunterView(char *pastPlays, PlayerMessage messages[]);
 
 
+// updateHunterView() brings the HunterView up to date with plays made since
+// it was created (or last updated), in the same format as pastPlays
+
+void updateHunterView(HunterView currentView, const char *newPlays);
+
+
+// cloneHunterView() copies the HunterView (cheaply: see cloneGameView())
+// so that plays can be tried out on the copy
+
+HunterView cloneHunterView(HunterView original);
+
+
 // disposeHunterView() frees all memory previously allocated for the HunterView
 // toBeDeleted. toBeDeleted should not be accessed after the call.
 
@@ -86,6 +101,22 @@ LocationID whereIs(HunterView currentView, PlayerID player);
 void giveMeTheTrail(HunterView currentView, PlayerID player,
                         LocationID trail[TRAIL_SIZE]);
 
+// giveMeTheWholeTrail() is giveMeTheTrail() for the whole game: it points
+//   at every move the player has made, oldest first (the one for round r
+//   at index r), and sets *numMoves to how many there are
+// The array is not a copy: it is only good until the view is updated
+
+const LocationID *giveMeTheWholeTrail(HunterView currentView, PlayerID player, int *numMoves);
+
+// giveMeTheMessage() gives the message left with a play (0 is the first
+//   play), or "" if the view was not given one
+const char *giveMeTheMessage(HunterView currentView, int play);
+
+// giveMeTheState() fills in a ViewState (see GameView.h) with what
+//   giveMeTheRound(), giveMeTheScore(), howHealthyIs(), whereIs() and
+//   giveMeTheTrail() would give for every player, all in one call
+void giveMeTheState(HunterView currentView, ViewState *state);
+
 
 //// Functions that query the map to find information about connectivity
 
@@ -117,4 +148,21 @@ LocationID *whereCanTheyGo(HunterView currentView, int *numLocations,
 LocationID *shortestPath(HunterView currentView, int *length, PlayerID player, LocationID start, LocationID end,
                          int road, int rail, int sea); 
 
+// Same as shortestPath(), but searches from both ends at once and stops
+//   as soon as the two searches meet
+// Returns a path of the same length as shortestPath() would
+
+LocationID *shortestPathBidir(HunterView currentView, int *length, PlayerID player, LocationID start,
+                              LocationID end, int road, int rail, int sea);
+
+// Counts the shortest routes the given player has from start to end,
+//   starting from the current round (see pathCounts() in GameView.h)
+// through[v] is the number of those routes passing through v, so the
+//   locations with the largest counts are the chokepoints worth covering
+// Returns the total number of shortest routes (0 if end can't be reached)
+
+int shortestPathCounts(HunterView currentView, PlayerID player, LocationID start, LocationID end,
+                       int road, int rail, int sea, int dist[NUM_MAP_LOCATIONS],
+                       int through[NUM_MAP_LOCATIONS]);
+
 #endif
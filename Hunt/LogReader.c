@@ -0,0 +1,67 @@
+// LogReader.c ... read the pastPlays of recorded games, for the tests and benchmarks
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <dirent.h>
+#include "GameState.h"
+#include "LogReader.h"
+
+#define PAST_PLAYS_KEY "\"pastPlays\": \""
+
+
+// Hands out every pastPlays string in a log, line by line
+void readLog(char *fileName, PlaysUser usePlays, void *arg)
+{
+    assert(fileName != NULL && usePlays != NULL);
+
+    FILE *f = fopen(fileName, "r");
+    if(f == NULL) {
+        perror(fileName);
+        exit(EXIT_FAILURE);
+    }
+
+    static char line[MAX_PLAYS * PLAY_LENGTH];
+    while(fgets(line, sizeof(line), f) != NULL) {
+        char *start = strstr(line, PAST_PLAYS_KEY);
+        if(start == NULL) continue;
+        start += strlen(PAST_PLAYS_KEY);
+
+        char *end = strchr(start, '"');
+        if(end == NULL) continue;
+        *end = '\0';
+
+        usePlays(start, end - start, arg);
+    }
+
+    fclose(f);
+}
+
+// Runs over the logs named, or all of GameLog/
+void forEachLog(int numFiles, char *fileNames[], void (*useLog)(char *fileName))
+{
+    assert(numFiles >= 0 && useLog != NULL);
+
+    int i;
+    if(numFiles > 0) {
+        for(i = 0; i < numFiles; i++) useLog(fileNames[i]);
+        return;
+    }
+
+    DIR *dir = opendir(LOG_DIR);
+    if(dir == NULL) {
+        perror(LOG_DIR);
+        exit(EXIT_FAILURE);
+    }
+
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL) {
+        if(strstr(entry->d_name, ".txt") == NULL) continue;
+
+        char fileName[sizeof(LOG_DIR) + 256];
+        sprintf(fileName, "%s/%.255s", LOG_DIR, entry->d_name);
+        useLog(fileName);
+    }
+    closedir(dir);
+}
@@ -0,0 +1,25 @@
+// LogReader.h ... read the pastPlays of recorded games, for the tests and benchmarks
+//
+// The logs in GameLog/ have a "pastPlays": "..." string for every turn of
+// a game. readLog() hands each of them out in turn; forEachLog() runs
+// over the logs a program was given, or every log in GameLog/ if none.
+// (Not part of the submission: the AIs never read logs.)
+
+#ifndef LOG_READER_H
+#define LOG_READER_H
+
+#define LOG_DIR "GameLog"
+#define MAX_PLAYS 4000
+
+// readLog() calls usePlays() on each pastPlays string in the log in
+// order, '\0'-terminated, with its length and 'arg'. The string is in a
+// buffer the next one is read into, so copy it to keep it. Exits if the
+// log can't be opened.
+typedef void (*PlaysUser)(char *pastPlays, int length, void *arg);
+void readLog(char *fileName, PlaysUser usePlays, void *arg);
+
+// forEachLog() calls useLog() on each of the numFiles logs named in
+// fileNames, or on every *.txt in GameLog/ when numFiles is 0
+void forEachLog(int numFiles, char *fileNames[], void (*useLog)(char *fileName));
+
+#endif
@@ -5,6 +5,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include "Map.h"
 #include "Places.h"
 
@@ -20,6 +21,7 @@ struct MapRep {
    int   nV;         // #vertices
    int   nE;         // #edges
    VList connections[NUM_MAP_LOCATIONS]; // array of lists
+   atomic_int refs;  // #holders sharing it (see shareMap)
 };
 
 static void addConnections(Map);
@@ -36,10 +38,20 @@ Map newMap()
       g->connections[i] = NULL;
    }
    g->nE = 0;
+   g->refs = 1;
    addConnections(g);
    return g;
 }
 
+// Share an existing graph; it is removed once every holder disposes it
+Map shareMap(Map g)
+{
+   assert(g != NULL);
+   assert(g->refs > 0);
+   g->refs++;
+   return g;
+}
+
 // Remove an existing graph
 void disposeMap(Map g)
 {
@@ -48,7 +60,9 @@ void disposeMap(Map g)
    VList next;
    assert(g != NULL);
    assert(g->connections != NULL);
+   assert(g->refs > 0);
 
+   if (--g->refs > 0) return;
    for (i = 0; i < g->nV; i++){
        curr = g->connections[i];
        while(curr != NULL){
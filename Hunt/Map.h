@@ -16,7 +16,8 @@ typedef struct MapRep *Map;
 
 // operations on graphs 
 Map  newMap();  
-void disposeMap(Map g); 
+Map  shareMap(Map g);    // the same graph, for another holder
+void disposeMap(Map g);  // frees it once the last holder disposes it
 void showMap(Map g); 
 int  numV(Map g);
 int  numE(Map g, TransportID t);
@@ -0,0 +1,300 @@
+// PQueue.c ... priority queues for searches over the map
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "PQueue.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define NOT_QUEUED -1
+
+typedef struct HeapRep {
+    int size;           // number of items in the heap
+    int capacity;       // items are 0..capacity-1
+    int owned;          // whether newHeap() allocated this heap
+    int unused;
+    int data[];         // heap[capacity], pos[capacity], cost[capacity]
+} HeapRep;
+
+#define heapAt(h)  ((h)->data)                        // heap order
+#define posOf(h)   ((h)->data + (h)->capacity)        // index in heapAt, or NOT_QUEUED
+#define costOf(h)  ((h)->data + 2 * (h)->capacity)
+
+typedef struct BucketQueueRep {
+    int size;           // number of items queued
+    int capacity;       // items are 0..capacity-1
+    int numBuckets;     // maxStep + 1; costs are kept modulo this
+    int current;        // lowest cost that can still be queued
+    int owned;          // whether newBucketQueue() allocated this queue
+    int unused[3];
+    int data[];         // head[numBuckets], next[capacity], prev[capacity], cost[capacity]
+} BucketQueueRep;
+
+#define headOf(b)  ((b)->data)
+#define nextOf(b)  ((b)->data + (b)->numBuckets)
+#define prevOf(b)  ((b)->data + (b)->numBuckets + (b)->capacity)
+#define bcostOf(b) ((b)->data + (b)->numBuckets + 2 * (b)->capacity)
+
+static void siftUp(Heap h, int i);
+static void siftDown(Heap h, int i);
+static void swapItems(Heap h, int i, int j);
+static void unlinkItem(BucketQueue b, int item);
+
+
+// *** Heap ***
+
+Heap newHeap(int capacity) {
+    assert(capacity > 0);
+
+    int *storage = malloc(HEAP_WORDS(capacity) * sizeof(int));
+    assert(storage != NULL);
+
+    Heap h = heapIn(storage, capacity);
+    h->owned = TRUE;
+
+    return h;
+}
+
+Heap heapIn(int *storage, int capacity) {
+    assert(storage != NULL);
+    assert(capacity > 0);
+    assert(sizeof(HeapRep) <= HEAP_HEADER_WORDS * sizeof(int));
+
+    Heap h = (Heap) storage;
+    h->capacity = capacity;
+    h->owned = FALSE;
+
+    int i;
+    for(i = 0; i < capacity; i++) posOf(h)[i] = NOT_QUEUED;
+    h->size = 0;
+
+    return h;
+}
+
+void disposeHeap(Heap h) {
+    if(h == NULL) return;
+
+    if(h->owned) free(h);
+}
+
+void resetHeap(Heap h) {
+    assert(h != NULL);
+
+    // only the items still queued need clearing
+    int i;
+    for(i = 0; i < h->size; i++) posOf(h)[heapAt(h)[i]] = NOT_QUEUED;
+    h->size = 0;
+}
+
+void enterHeap(Heap h, int item, int cost) {
+    assert(h != NULL);
+    assert(item >= 0 && item < h->capacity);
+
+    int i = posOf(h)[item];
+    if(i == NOT_QUEUED) {
+        i = h->size++;
+        heapAt(h)[i] = item;
+        posOf(h)[item] = i;
+    } else {
+        // decrease-key only
+        assert(cost <= costOf(h)[item]);
+    }
+
+    costOf(h)[item] = cost;
+    siftUp(h, i);
+}
+
+int leaveHeap(Heap h, int *cost) {
+    assert(h != NULL);
+    assert(h->size > 0);
+
+    int item = heapAt(h)[0];
+    if(cost != NULL) *cost = costOf(h)[item];
+
+    h->size--;
+    if(h->size > 0) {
+        swapItems(h, 0, h->size);
+        siftDown(h, 0);
+    }
+    posOf(h)[item] = NOT_QUEUED;
+
+    return item;
+}
+
+int inHeap(Heap h, int item) {
+    assert(h != NULL);
+    assert(item >= 0 && item < h->capacity);
+
+    return posOf(h)[item] != NOT_QUEUED;
+}
+
+int emptyHeap(Heap h) {
+    assert(h != NULL);
+
+    if(h->size == 0) {
+        return TRUE;
+    } else {
+        return FALSE;
+    }
+}
+
+
+// *** BucketQueue ***
+
+BucketQueue newBucketQueue(int capacity, int maxStep) {
+    assert(capacity > 0 && maxStep >= 0);
+
+    int *storage = malloc(BUCKET_QUEUE_WORDS(capacity, maxStep) * sizeof(int));
+    assert(storage != NULL);
+
+    BucketQueue b = bucketQueueIn(storage, capacity, maxStep);
+    b->owned = TRUE;
+
+    return b;
+}
+
+BucketQueue bucketQueueIn(int *storage, int capacity, int maxStep) {
+    assert(storage != NULL);
+    assert(capacity > 0 && maxStep >= 0);
+    assert(sizeof(BucketQueueRep) <= BUCKET_QUEUE_HEADER_WORDS * sizeof(int));
+
+    BucketQueue b = (BucketQueue) storage;
+    b->capacity = capacity;
+    b->numBuckets = maxStep + 1;
+    b->owned = FALSE;
+
+    int i;
+    for(i = 0; i < b->numBuckets; i++) headOf(b)[i] = NOT_QUEUED;
+    for(i = 0; i < capacity; i++) bcostOf(b)[i] = NOT_QUEUED;
+    b->size = 0;
+    b->current = 0;
+
+    return b;
+}
+
+void disposeBucketQueue(BucketQueue b) {
+    if(b == NULL) return;
+
+    if(b->owned) free(b);
+}
+
+void resetBucketQueue(BucketQueue b) {
+    assert(b != NULL);
+
+    // only the buckets still holding items need clearing
+    int i;
+    for(i = 0; i < b->numBuckets && b->size > 0; i++) {
+        while(headOf(b)[i] != NOT_QUEUED) {
+            int item = headOf(b)[i];
+            unlinkItem(b, item);
+            b->size--;
+        }
+    }
+    b->current = 0;
+}
+
+void enterBucketQueue(BucketQueue b, int item, int cost) {
+    assert(b != NULL);
+    assert(item >= 0 && item < b->capacity);
+    assert(cost >= b->current && cost < b->current + b->numBuckets);
+
+    if(bcostOf(b)[item] != NOT_QUEUED) {
+        // decrease-key only
+        assert(cost <= bcostOf(b)[item]);
+        unlinkItem(b, item);
+    } else {
+        b->size++;
+    }
+
+    int bucket = cost % b->numBuckets;
+    bcostOf(b)[item] = cost;
+    prevOf(b)[item] = NOT_QUEUED;
+    nextOf(b)[item] = headOf(b)[bucket];
+    if(headOf(b)[bucket] != NOT_QUEUED) prevOf(b)[headOf(b)[bucket]] = item;
+    headOf(b)[bucket] = item;
+}
+
+int leaveBucketQueue(BucketQueue b, int *cost) {
+    assert(b != NULL);
+    assert(b->size > 0);
+
+    // costs only go up, so scan forwards from the last cost taken out
+    while(headOf(b)[b->current % b->numBuckets] == NOT_QUEUED) b->current++;
+
+    int item = headOf(b)[b->current % b->numBuckets];
+    if(cost != NULL) *cost = bcostOf(b)[item];
+
+    unlinkItem(b, item);
+    b->size--;
+
+    return item;
+}
+
+int inBucketQueue(BucketQueue b, int item) {
+    assert(b != NULL);
+    assert(item >= 0 && item < b->capacity);
+
+    return bcostOf(b)[item] != NOT_QUEUED;
+}
+
+int emptyBucketQueue(BucketQueue b) {
+    assert(b != NULL);
+
+    if(b->size == 0) {
+        return TRUE;
+    } else {
+        return FALSE;
+    }
+}
+
+
+// *** Private Functions ***
+
+static void siftUp(Heap h, int i) {
+    while(i > 0) {
+        int parent = (i - 1) / 2;
+        if(costOf(h)[heapAt(h)[parent]] <= costOf(h)[heapAt(h)[i]]) break;
+
+        swapItems(h, i, parent);
+        i = parent;
+    }
+}
+
+static void siftDown(Heap h, int i) {
+    for(;;) {
+        int smallest = i;
+        int left = 2 * i + 1, right = left + 1;
+
+        if(left < h->size && costOf(h)[heapAt(h)[left]] < costOf(h)[heapAt(h)[smallest]]) smallest = left;
+        if(right < h->size && costOf(h)[heapAt(h)[right]] < costOf(h)[heapAt(h)[smallest]]) smallest = right;
+        if(smallest == i) break;
+
+        swapItems(h, i, smallest);
+        i = smallest;
+    }
+}
+
+static void swapItems(Heap h, int i, int j) {
+    int a = heapAt(h)[i], b = heapAt(h)[j];
+
+    heapAt(h)[i] = b;
+    heapAt(h)[j] = a;
+    posOf(h)[b] = i;
+    posOf(h)[a] = j;
+}
+
+// Takes an item out of its bucket's list
+static void unlinkItem(BucketQueue b, int item) {
+    int bucket = bcostOf(b)[item] % b->numBuckets;
+
+    if(prevOf(b)[item] != NOT_QUEUED) {
+        nextOf(b)[prevOf(b)[item]] = nextOf(b)[item];
+    } else {
+        headOf(b)[bucket] = nextOf(b)[item];
+    }
+    if(nextOf(b)[item] != NOT_QUEUED) prevOf(b)[nextOf(b)[item]] = prevOf(b)[item];
+
+    bcostOf(b)[item] = NOT_QUEUED;
+}
@@ -0,0 +1,48 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Places.h"
+
+// Priority queues of items 0..capacity-1 (LocationIDs, or search states)
+// keyed by an integer cost, lowest cost first
+// Like Queue, the capacity is fixed at creation and entering/leaving
+// never allocates; each can also be laid out in caller storage
+
+// Heap: a binary heap with decrease-key, for any costs
+
+typedef struct HeapRep *Heap;
+
+#define HEAP_HEADER_WORDS 4
+#define HEAP_WORDS(capacity) (HEAP_HEADER_WORDS + 3 * (capacity))
+
+Heap newHeap(int capacity);                    // allocates once
+Heap heapIn(int *storage, int capacity);       // never allocates
+void disposeHeap(Heap);                        // no-op for heapIn heaps
+void resetHeap(Heap);                          // empty it, ready for the next search
+void enterHeap(Heap, int item, int cost);      // insert, or lower the cost of an item already in
+int leaveHeap(Heap, int *cost);                // remove a lowest-cost item (cost may be NULL)
+int inHeap(Heap, int item);
+int emptyHeap(Heap);
+
+// BucketQueue: a monotone bucket queue for small integer costs
+// Each cost entered must be between the cost last taken out and that plus
+// maxStep (true for Dijkstra when no single move costs more than maxStep)
+
+typedef struct BucketQueueRep *BucketQueue;
+
+#define BUCKET_QUEUE_HEADER_WORDS 8
+#define BUCKET_QUEUE_WORDS(capacity, maxStep) \
+    (BUCKET_QUEUE_HEADER_WORDS + (maxStep) + 1 + 3 * (capacity))
+
+BucketQueue newBucketQueue(int capacity, int maxStep);
+BucketQueue bucketQueueIn(int *storage, int capacity, int maxStep);
+void disposeBucketQueue(BucketQueue);
+void resetBucketQueue(BucketQueue);
+void enterBucketQueue(BucketQueue, int item, int cost);
+int leaveBucketQueue(BucketQueue, int *cost);
+int inBucketQueue(BucketQueue, int item);
+int emptyBucketQueue(BucketQueue);
+
+#endif
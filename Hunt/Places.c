@@ -16,7 +16,7 @@ typedef struct Place {
 // Each entry should satisfy (places[i].id == i)
 // First real place must be at index MIN_MAP_LOCATION
 // Last real place must be at index MAX_MAP_LOCATION
-static Place places[] =
+static const Place places[] =
 {
    {"Adriatic Sea", "AS", ADRIATIC_SEA, SEA},
    {"Alicante", "AL", ALICANTE, LAND},
@@ -91,6 +91,101 @@ static Place places[] =
    {"Zurich", "ZU", ZURICH, LAND},
 };
 
+// Two char moves, indexed by their chars so they decode in one lookup
+// Each entry holds the ID + 1, so the zeroes in between mean "not a move"
+// Every place must also appear here with the abbreviation it has in places[]
+#define MOVE_CHARS ('Z' - '0' + 1)    // second chars run from '0' to 'Z' (including '?')
+#define MOVE_SLOT(c0, c1) (((c0) - 'A') * MOVE_CHARS + ((c1) - '0'))
+#define MOVE(c0, c1, id) [MOVE_SLOT(c0, c1)] = (id) + 1
+static const unsigned char moves[26 * MOVE_CHARS] =
+{
+   MOVE('A', 'S', ADRIATIC_SEA),
+   MOVE('A', 'L', ALICANTE),
+   MOVE('A', 'M', AMSTERDAM),
+   MOVE('A', 'T', ATHENS),
+   MOVE('A', 'O', ATLANTIC_OCEAN),
+   MOVE('B', 'A', BARCELONA),
+   MOVE('B', 'I', BARI),
+   MOVE('B', 'B', BAY_OF_BISCAY),
+   MOVE('B', 'E', BELGRADE),
+   MOVE('B', 'R', BERLIN),
+   MOVE('B', 'S', BLACK_SEA),
+   MOVE('B', 'O', BORDEAUX),
+   MOVE('B', 'U', BRUSSELS),
+   MOVE('B', 'C', BUCHAREST),
+   MOVE('B', 'D', BUDAPEST),
+   MOVE('C', 'A', CADIZ),
+   MOVE('C', 'G', CAGLIARI),
+   MOVE('C', 'D', CASTLE_DRACULA),
+   MOVE('C', 'F', CLERMONT_FERRAND),
+   MOVE('C', 'O', COLOGNE),
+   MOVE('C', 'N', CONSTANTA),
+   MOVE('D', 'U', DUBLIN),
+   MOVE('E', 'D', EDINBURGH),
+   MOVE('E', 'C', ENGLISH_CHANNEL),
+   MOVE('F', 'L', FLORENCE),
+   MOVE('F', 'R', FRANKFURT),
+   MOVE('G', 'A', GALATZ),
+   MOVE('G', 'W', GALWAY),
+   MOVE('G', 'E', GENEVA),
+   MOVE('G', 'O', GENOA),
+   MOVE('G', 'R', GRANADA),
+   MOVE('H', 'A', HAMBURG),
+   MOVE('I', 'O', IONIAN_SEA),
+   MOVE('I', 'R', IRISH_SEA),
+   MOVE('K', 'L', KLAUSENBURG),
+   MOVE('L', 'E', LE_HAVRE),
+   MOVE('L', 'I', LEIPZIG),
+   MOVE('L', 'S', LISBON),
+   MOVE('L', 'V', LIVERPOOL),
+   MOVE('L', 'O', LONDON),
+   MOVE('M', 'A', MADRID),
+   MOVE('M', 'N', MANCHESTER),
+   MOVE('M', 'R', MARSEILLES),
+   MOVE('M', 'S', MEDITERRANEAN_SEA),
+   MOVE('M', 'I', MILAN),
+   MOVE('M', 'U', MUNICH),
+   MOVE('N', 'A', NANTES),
+   MOVE('N', 'P', NAPLES),
+   MOVE('N', 'S', NORTH_SEA),
+   MOVE('N', 'U', NUREMBURG),
+   MOVE('P', 'A', PARIS),
+   MOVE('P', 'L', PLYMOUTH),
+   MOVE('P', 'R', PRAGUE),
+   MOVE('R', 'O', ROME),
+   MOVE('S', 'A', SALONICA),
+   MOVE('S', 'N', SANTANDER),
+   MOVE('S', 'R', SARAGOSSA),
+   MOVE('S', 'J', SARAJEVO),
+   MOVE('S', 'O', SOFIA),
+   MOVE('J', 'M', ST_JOSEPH_AND_ST_MARYS),
+   MOVE('S', 'T', STRASBOURG),
+   MOVE('S', 'W', SWANSEA),
+   MOVE('S', 'Z', SZEGED),
+   MOVE('T', 'O', TOULOUSE),
+   MOVE('T', 'S', TYRRHENIAN_SEA),
+   MOVE('V', 'A', VALONA),
+   MOVE('V', 'R', VARNA),
+   MOVE('V', 'E', VENICE),
+   MOVE('V', 'I', VIENNA),
+   MOVE('Z', 'A', ZAGREB),
+   MOVE('Z', 'U', ZURICH),
+
+   // Dracula's special moves
+   MOVE('C', '?', CITY_UNKNOWN),
+   MOVE('S', '?', SEA_UNKNOWN),
+   MOVE('H', 'I', HIDE),
+   MOVE('D', '1', DOUBLE_BACK_1),
+   MOVE('D', '2', DOUBLE_BACK_2),
+   MOVE('D', '3', DOUBLE_BACK_3),
+   MOVE('D', '4', DOUBLE_BACK_4),
+   MOVE('D', '5', DOUBLE_BACK_5),
+   MOVE('T', 'P', TELEPORT),
+};
+
+// Abbreviations of Dracula's special moves, from CITY_UNKNOWN to TELEPORT
+static char *const specialAbbrevs[] = {"C?", "S?", "HI", "D1", "D2", "D3", "D4", "D5", "TP"};
+
 // given a Place number, return its name
 char *idToName(LocationID p)
 {
@@ -126,13 +221,24 @@ int nameToID(char *name)
 // given a Place abbreviation (2 char), return its ID number
 int abbrevToID(char *abbrev)
 {
-   // an attempt to optimise a linear search
-   Place *p;
-   Place *first = &places[MIN_MAP_LOCATION];
-   Place *last = &places[MAX_MAP_LOCATION];
-   for (p = first; p <= last; p++) {
-      char *c = p->abbrev;
-      if (c[0] == abbrev[0] && c[1] == abbrev[1] && c[2] == '\0') return p->id;
-   }
-   return NOWHERE;
+   int id = moveToID(abbrev);
+   if (!validPlace(id)) return NOWHERE;
+   return id;
+}
+
+// given any two char move (a Place abbreviation or one of
+// C?, S?, HI, D1-D5, TP), return its ID number
+int moveToID(const char *move)
+{
+   char c0 = move[0], c1 = move[1];
+   if (c0 < 'A' || c0 > 'Z' || c1 < '0' || c1 > 'Z') return NOWHERE;
+   return moves[MOVE_SLOT(c0, c1)] - 1;
+}
+
+// given a Place number or special move, return its abbreviation
+char *idToAbbrev(int place)
+{
+   if (validPlace(place)) return places[place].abbrev;
+   assert(place >= CITY_UNKNOWN && place <= TELEPORT);
+   return specialAbbrevs[place - CITY_UNKNOWN];
 }
@@ -129,9 +129,29 @@ int nameToID(char *name);
 // given a Place abbreviation, return its ID number
 int abbrevToID(char *abbrev);
 
+// given any two char move (a Place abbreviation or one of
+// C?, S?, HI, D1-D5, TP), return its ID number, or NOWHERE
+int moveToID(const char *move);
+
+// given a Place number or special move, return its abbreviation
+char *idToAbbrev(int place);
+
 #define isLand(place)  (idToType(place) == LAND)
 #define isSea(place)  (idToType(place) == SEA)
 
 #define validPlace(pid) (pid >= MIN_MAP_LOCATION && pid <= MAX_MAP_LOCATION)
+// a Place or one of the special moves: anything moveToID() can give but NOWHERE
+#define validMove(pid)  (validPlace(pid) || (pid >= CITY_UNKNOWN && pid <= TELEPORT))
+
+// A set of places, one bit per place
+typedef struct locationSet {
+   unsigned long long bits[2];
+} LocationSet;
+
+#define emptySet(set)      ((set).bits[0] = (set).bits[1] = 0)
+#define addToSet(set,pid)  ((set).bits[(pid)/64] |= 1ULL << ((pid)%64))
+#define inSet(set,pid)     (((set).bits[(pid)/64] >> ((pid)%64)) & 1)
+#define unionSet(a,b)      ((a).bits[0] |= (b).bits[0], (a).bits[1] |= (b).bits[1])
+#define intersects(a,b)    ((((a).bits[0] & (b).bits[0]) | ((a).bits[1] & (b).bits[1])) != 0)
 
 #endif
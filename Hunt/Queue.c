@@ -7,24 +7,37 @@
 #define TRUE 1
 #define FALSE 0
 
-typedef struct QueueNode *Node;
-struct QueueNode {
-    LocationID v;
-    Node next;
-} QueueNode;
-
 typedef struct QueueRep {
-	Node head;
-	Node tail;
+    int head;           // index of the item at the front
+    int size;           // number of items in the queue
+    int capacity;       // number of slots in items[]
+    int owned;          // whether newQueue() allocated this queue
+    LocationID items[]; // the ring buffer
 } QueueRep;
 
 
-Queue newQueue() {
-    Queue q = malloc(sizeof(QueueRep));
+Queue newQueue(int capacity) {
+    assert(capacity > 0);
+
+    Queue q = malloc(QUEUE_WORDS(capacity) * sizeof(LocationID));
     assert(q != NULL);
-    
-    q->head = NULL;
-    q->tail = NULL;
+
+    q = queueIn((LocationID *) q, capacity);
+    q->owned = TRUE;
+
+    return q;
+}
+
+Queue queueIn(LocationID *storage, int capacity) {
+    assert(storage != NULL);
+    assert(capacity > 0);
+    assert(sizeof(QueueRep) <= QUEUE_HEADER_WORDS * sizeof(LocationID));
+
+    Queue q = (Queue) storage;
+    q->head = 0;
+    q->size = 0;
+    q->capacity = capacity;
+    q->owned = FALSE;
 
     return q;
 }
@@ -32,51 +45,36 @@ Queue newQueue() {
 void disposeQueue(Queue q) {
     if(q == NULL) return;
 
-    Node curr = q->head;
-    Node prev = q->head;
+    if(q->owned) free(q); 
+}
 
-    while(curr != NULL) {
-        prev = curr;
-        curr = curr->next;
-        free(prev);
-    }
+void resetQueue(Queue q) {
+    assert(q != NULL);
 
-    free(q); 
+    q->head = 0;
+    q->size = 0;
 }
 
 void enterQueue(Queue q, LocationID location) {
     assert(q != NULL);
-    
-    Node newNode = malloc(sizeof(QueueNode));
-    assert(newNode != NULL);
+    assert(q->size < q->capacity);
 
-    newNode->v = location;
-    newNode->next = NULL;
-
-    if(q->head == NULL) {
-        q->head = newNode;
-        q->tail = newNode;
-    } else {
-        q->tail->next = newNode;
-        q->tail = newNode;
-    }
+    int tail = q->head + q->size;
+    if(tail >= q->capacity) tail -= q->capacity;
 
+    q->items[tail] = location;
+    q->size++;
 }
 
 LocationID leaveQueue(Queue q) {
     assert(q != NULL);
-    assert(q->head != NULL);
+    assert(q->size > 0);
 
-    LocationID location =  q->head->v;
+    LocationID location = q->items[q->head];
 
-    if(q->head == q->tail) {
-        free(q->head);
-        q->head = q->tail = NULL;
-    } else {
-        Node nextNode = q->head->next;
-        free(q->head);
-        q->head = nextNode;
-    }
+    q->head++;
+    if(q->head == q->capacity) q->head = 0;
+    q->size--;
 
     return location;
 }
@@ -84,10 +82,9 @@ LocationID leaveQueue(Queue q) {
 int emptyQueue(Queue q) {
     assert(q != NULL);
     
-    if(q->head == NULL) {
+    if(q->size == 0) {
         return TRUE;
     } else {
         return FALSE;
     }
 }
-
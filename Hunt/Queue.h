@@ -5,13 +5,26 @@
 #include <stdlib.h>
 #include "Places.h"
 
+// A fixed-capacity FIFO queue of LocationIDs kept in a ring buffer,
+// so entering and leaving the queue never allocates
+
 typedef struct QueueRep *Queue;
 
-Queue newQueue();
-void disposeQueue(Queue);
+// Number of LocationID-sized words a queue needs besides its items
+#define QUEUE_HEADER_WORDS 4
+
+// Storage for a queue holding up to 'capacity' items, for a queue that
+// lives on the stack or in an arena, e.g.
+//    LocationID storage[QUEUE_WORDS(NUM_MAP_LOCATIONS)];
+//    Queue q = queueIn(storage, NUM_MAP_LOCATIONS);
+#define QUEUE_WORDS(capacity) (QUEUE_HEADER_WORDS + (capacity))
+
+Queue newQueue(int capacity);                      // allocates once
+Queue queueIn(LocationID *storage, int capacity);  // never allocates
+void disposeQueue(Queue);                          // no-op for queueIn queues
+void resetQueue(Queue);                            // empty it, ready for the next search
 void enterQueue(Queue, LocationID);
 LocationID leaveQueue(Queue);
 int emptyQueue(Queue);
 
 #endif
-
@@ -0,0 +1,19 @@
+// Random.c ... random choices for the AIs, each Random on a seed of its own
+
+#include <stdlib.h>
+#include <assert.h>
+#include "Random.h"
+
+// Starts a Random off
+void seedRandom(Random *random, unsigned int seed)
+{
+    assert(random != NULL);
+    random->seed = seed;
+}
+
+// A number from 0 to n - 1
+int randomIndex(Random *random, int n)
+{
+    assert(random != NULL && n > 0);
+    return rand_r(&random->seed) % n;
+}
@@ -0,0 +1,20 @@
+// Random.h ... random choices for the AIs
+//
+// rand() keeps one seed for the whole program; a Random keeps its own, so
+// several AIs can choose at once. Seed it once per decision and hand it
+// to everything that chooses.
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+typedef struct random {
+    unsigned int seed;
+} Random;
+
+// seedRandom() starts a Random off, e.g. seedRandom(&random, time(NULL))
+void seedRandom(Random *random, unsigned int seed);
+
+// randomIndex() gives a number from 0 to n - 1 (n > 0) and moves the Random on
+int randomIndex(Random *random, int n);
+
+#endif
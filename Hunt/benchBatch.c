@@ -0,0 +1,90 @@
+// benchBatch.c ... time parsing every recorded position
+//
+// Pulls every "pastPlays" string out of the given game logs and reports
+// positions per second for building a GameView of each in turn, and for
+// parseBatch() with one thread and with one thread per processor.
+// Usage: ./benchBatch [-r repetitions] GameLog/*.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include "GameView.h"
+#include "GameBatch.h"
+#include "LogReader.h"
+
+#define DEFAULT_REPS 20
+#define MAX_POSITIONS 100000
+
+static char *positions[MAX_POSITIONS];
+static GameState states[MAX_POSITIONS];
+static int numPositions;
+
+static void keepPositions(char *fileName);
+static void keepPosition(char *pastPlays, int length, void *arg);
+static double now(void);
+static void report(char *what, int reps, double seconds);
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS;
+    int i = 1, r;
+    if(argc > 2 && strcmp(argv[1], "-r") == 0) {
+        reps = atoi(argv[2]);
+        i = 3;
+    }
+    assert(reps > 0);
+    if(i >= argc) {
+        fprintf(stderr, "Usage: %s [-r repetitions] log...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    forEachLog(argc - i, argv + i, keepPositions);
+    assert(numPositions > 0);
+
+    double start = now();
+    for(r = 0; r < reps; r++) {
+        for(i = 0; i < numPositions; i++) disposeGameView(newGameView(positions[i], NULL));
+    }
+    report("newGameView one at a time", reps, now() - start);
+
+    start = now();
+    for(r = 0; r < reps; r++) parseBatch(positions, numPositions, states, 1);
+    report("parseBatch, 1 thread", reps, now() - start);
+
+    int threads = sysconf(_SC_NPROCESSORS_ONLN);
+    char what[64];
+    sprintf(what, "parseBatch, %d threads", threads);
+    start = now();
+    for(r = 0; r < reps; r++) parseBatch(positions, numPositions, states, threads);
+    report(what, reps, now() - start);
+
+    for(i = 0; i < numPositions; i++) free(positions[i]);
+    return EXIT_SUCCESS;
+}
+
+// Keeps every pastPlays string in a log
+static void keepPositions(char *fileName) {
+    readLog(fileName, keepPosition, NULL);
+}
+
+static void keepPosition(char *pastPlays, int length, void *arg) {
+    if(numPositions == MAX_POSITIONS) return;
+
+    positions[numPositions] = malloc(length + 1);
+    assert(positions[numPositions] != NULL);
+    strcpy(positions[numPositions++], pastPlays);
+}
+
+// Wall clock seconds (clock() would add up every thread's time)
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void report(char *what, int reps, double seconds) {
+    printf("%-27s %6d positions: %8.3f s  %10.0f positions/s\n",
+           what, numPositions, seconds, (double) numPositions * reps / seconds);
+}
@@ -0,0 +1,128 @@
+// benchChecks.c ... time the calls an AI makes in its inner loops
+//
+// Builds a DracView of the longest game in the given logs that shows
+// where Dracula went, then times the cheap accessors, giveMeTheState()
+// (which answers most of what they do in one call) and the move
+// generators on it. Build it at each CHECK_LEVEL to see what each tier
+// of checking costs ("make checkbench" does all three).
+// Usage: ./benchChecks [-r repetitions] GameLog/*.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "Globals.h"
+#include "Check.h"
+#include "DracView.h"
+#include "LogReader.h"
+
+#define DEFAULT_REPS 20000
+
+static char *game;
+volatile int sink;                   // keeps the answers from being optimised away
+
+static void keepLongest(char *fileName);
+static void keepIfLongest(char *pastPlays, int length, void *arg);
+static long accessors(DracView dv);
+static long generators(DracView dv);
+static void report(char *what, long calls, double seconds);
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS;
+    int i = 1, r;
+    if(argc > 2 && strcmp(argv[1], "-r") == 0) {
+        reps = atoi(argv[2]);
+        i = 3;
+    }
+    assert(reps > 0);
+    if(i >= argc) {
+        fprintf(stderr, "Usage: %s [-r repetitions] log...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    forEachLog(argc - i, argv + i, keepLongest);
+    assert(game != NULL);
+    DracView dv = newDracView(game, NULL);
+
+    printf("CHECK_LEVEL %d\n", CHECK_LEVEL);
+
+    long calls = 0;
+    clock_t start = clock();
+    for(r = 0; r < reps; r++) calls += accessors(dv);
+    report("accessors", calls, (double) (clock() - start) / CLOCKS_PER_SEC);
+
+    ViewState state;
+    start = clock();
+    for(r = 0; r < reps; r++) {
+        giveMeTheState(dv, &state);
+        sink = state.location[r % NUM_PLAYERS];
+    }
+    report("giveMeTheState", reps, (double) (clock() - start) / CLOCKS_PER_SEC);
+
+    calls = 0;
+    start = clock();
+    for(r = 0; r < reps; r++) calls += generators(dv);
+    report("move generators", calls, (double) (clock() - start) / CLOCKS_PER_SEC);
+
+    disposeDracView(dv);
+    free(game);
+    return EXIT_SUCCESS;
+}
+
+// Keeps the longest pastPlays in a log that shows where Dracula went
+static void keepLongest(char *fileName) {
+    readLog(fileName, keepIfLongest, NULL);
+}
+
+static void keepIfLongest(char *pastPlays, int length, void *arg) {
+    if(strstr(pastPlays, "DC?") != NULL || strstr(pastPlays, "DS?") != NULL) return;
+    if(game != NULL && strlen(game) >= length) return;
+
+    free(game);
+    game = malloc(length + 1);
+    assert(game != NULL);
+    strcpy(game, pastPlays);
+}
+
+// What an evaluation asks about every player, returning how many calls it made
+static long accessors(DracView dv) {
+    LocationID trail[TRAIL_SIZE];
+    long calls = 0;
+
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        LocationID start, end;
+        int numTraps, numVamps;
+
+        sink = giveMeTheRound(dv) + giveMeTheScore(dv) + howHealthyIs(dv, p);
+        sink = whereIs(dv, p);
+        giveMeTheTrail(dv, p, trail);
+        sink = trail[TRAIL_SIZE - 1];
+        lastMove(dv, p, &start, &end);
+        sink = start + end;
+        whatsThere(dv, whereIs(dv, PLAYER_DRACULA), &numTraps, &numVamps);
+        sink = numTraps + numVamps;
+        sink = huntersThreatening(dv, trail[0] == UNKNOWN_LOCATION ? CASTLE_DRACULA : trail[0], 2);
+        calls += 11;
+    }
+
+    return calls;
+}
+
+// Every player's next moves, returning how many lists it made
+static long generators(DracView dv) {
+    int numLocations;
+    free(whereCanIgo(dv, &numLocations, TRUE, TRUE));
+
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p < PLAYER_DRACULA; p++) {
+        free(whereCanTheyGo(dv, &numLocations, p, TRUE, TRUE, TRUE));
+    }
+
+    return NUM_PLAYERS;
+}
+
+static void report(char *what, long calls, double seconds) {
+    printf("%-16s %10ld calls: %8.3f s  %8.1f ns/call\n", what, calls, seconds, seconds * 1e9 / calls);
+}
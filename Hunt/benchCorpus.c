@@ -0,0 +1,120 @@
+// benchCorpus.c ... time reading every position in a corpus
+//
+// For each pass over the given corpus files, times finding the positions
+// alone (in MB/s of file), feeding one GameView through them with
+// feedGameView(), and copying each position out to build a view of it
+// from scratch the way the other tools read logs.
+// Usage: ./benchCorpus [-r repetitions] GameLog/*.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "Globals.h"
+#include "GameView.h"
+#include "Corpus.h"
+
+#define DEFAULT_REPS 3
+
+static long scan(char *fileName);
+static long feed(char *fileName);
+static long rebuild(char *fileName);
+static void timePasses(char *what, long (*pass)(char *), char *files[], int numFiles, int reps);
+
+static double megabytes;
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS;
+    int i = 1;
+    if(argc > 2 && strcmp(argv[1], "-r") == 0) {
+        reps = atoi(argv[2]);
+        i = 3;
+    }
+    assert(reps > 0);
+    if(i >= argc) {
+        fprintf(stderr, "Usage: %s [-r repetitions] corpus...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char **files = argv + i;
+    int numFiles = argc - i;
+    for(i = 0; i < numFiles; i++) {
+        struct stat info;
+        if(stat(files[i], &info) < 0) {
+            perror(files[i]);
+            return EXIT_FAILURE;
+        }
+        megabytes += info.st_size / 1e6;
+    }
+
+    timePasses("nextPosition", scan, files, numFiles, reps);
+    timePasses("feedGameView", feed, files, numFiles, reps);
+    timePasses("copy + newGameView", rebuild, files, numFiles, reps);
+
+    return EXIT_SUCCESS;
+}
+
+// Finds every position, returning how many
+static long scan(char *fileName) {
+    Corpus corpus = openCorpus(fileName);
+    assert(corpus != NULL);
+
+    long positions = 0;
+    Position position;
+    while(nextPosition(corpus, &position)) positions++;
+
+    closeCorpus(corpus);
+    return positions;
+}
+
+// Feeds one view through every position
+static long feed(char *fileName) {
+    Corpus corpus = openCorpus(fileName);
+    assert(corpus != NULL);
+
+    long positions = 0;
+    GameView view = NULL;
+    while(feedGameView(corpus, &view)) positions++;
+
+    if(view != NULL) disposeGameView(view);
+    closeCorpus(corpus);
+    return positions;
+}
+
+// Copies each position into a string of its own and builds a view of it
+static long rebuild(char *fileName) {
+    Corpus corpus = openCorpus(fileName);
+    assert(corpus != NULL);
+
+    long positions = 0;
+    Position position;
+    while(nextPosition(corpus, &position)) {
+        char *plays = malloc(position.length + 1);
+        assert(plays != NULL);
+        memcpy(plays, position.plays, position.length);
+        plays[position.length] = '\0';
+
+        disposeGameView(newGameView(plays, NULL));
+        free(plays);
+        positions++;
+    }
+
+    closeCorpus(corpus);
+    return positions;
+}
+
+static void timePasses(char *what, long (*pass)(char *), char *files[], int numFiles, int reps) {
+    long positions = 0;
+    int r, i;
+
+    clock_t start = clock();
+    for(r = 0; r < reps; r++) {
+        for(i = 0; i < numFiles; i++) positions += pass(files[i]);
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-20s %8ld positions: %8.3f s  %10.0f positions/s  %8.1f MB/s\n",
+           what, positions / reps, seconds, positions / seconds, megabytes * reps / seconds);
+}
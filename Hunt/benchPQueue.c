@@ -0,0 +1,146 @@
+// benchPQueue.c ... time Heap against BucketQueue on the game map
+//
+// Runs Dijkstra from every location, with Dracula's moves costing
+// 1 + LIFE_LOSS_SEA when they end at sea, once per queue, and checks
+// both give the same costs. Usage: ./benchPQueue [repetitions]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <time.h>
+#include "GameView.h"
+#include "PQueue.h"
+
+#define DEFAULT_REPS 2000
+#define MAX_STEP (1 + LIFE_LOSS_SEA)
+#define UNSEEN -1
+
+typedef struct edges {
+    int numEdges[NUM_MAP_LOCATIONS];
+    LocationID to[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS];
+} Edges;
+
+static void buildEdges(Edges *e);
+static int stepCost(LocationID to);
+static double dijkstraHeap(Edges *e, int reps, int cost[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS]);
+static double dijkstraBuckets(Edges *e, int reps, int cost[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS]);
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS;
+    if(argc > 1) reps = atoi(argv[1]);
+    assert(reps > 0);
+
+    static Edges e;
+    static int heapCost[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS];
+    static int bucketCost[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS];
+    buildEdges(&e);
+
+    double heapTime = dijkstraHeap(&e, reps, heapCost);
+    double bucketTime = dijkstraBuckets(&e, reps, bucketCost);
+
+    int i, j;
+    for(i = 0; i < NUM_MAP_LOCATIONS; i++) {
+        for(j = 0; j < NUM_MAP_LOCATIONS; j++) assert(heapCost[i][j] == bucketCost[i][j]);
+    }
+
+    long searches = (long) reps * NUM_MAP_LOCATIONS;
+    printf("%d x %d searches\n", reps, NUM_MAP_LOCATIONS);
+    printf("Heap:        %8.3f s  %8.0f searches/s\n", heapTime, searches / heapTime);
+    printf("BucketQueue: %8.3f s  %8.0f searches/s\n", bucketTime, searches / bucketTime);
+
+    return EXIT_SUCCESS;
+}
+
+// Dracula's moves by road and sea, worked out once so only the queues are timed
+static void buildEdges(Edges *e) {
+    PlayerMessage messages[] = {""};
+    GameView gv = newGameView("", messages);
+    int reachable[NUM_MAP_LOCATIONS];
+
+    LocationID from, to;
+    for(from = MIN_MAP_LOCATION; from <= MAX_MAP_LOCATION; from++) {
+        e->numEdges[from] = 0;
+        if(from == ST_JOSEPH_AND_ST_MARYS) continue;   // Dracula can't go there
+        reachableFrom(gv, reachable, from, PLAYER_DRACULA, 0, TRUE, FALSE, TRUE);
+        for(to = MIN_MAP_LOCATION; to <= MAX_MAP_LOCATION; to++) {
+            if(reachable[to] && to != from) e->to[from][e->numEdges[from]++] = to;
+        }
+    }
+
+    disposeGameView(gv);
+}
+
+static int stepCost(LocationID to) {
+    if(isSea(to)) return 1 + LIFE_LOSS_SEA;
+    return 1;
+}
+
+static double dijkstraHeap(Edges *e, int reps, int cost[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS]) {
+    int storage[HEAP_WORDS(NUM_MAP_LOCATIONS)];
+    Heap h = heapIn(storage, NUM_MAP_LOCATIONS);
+
+    clock_t start = clock();
+    int r;
+    LocationID from;
+    for(r = 0; r < reps; r++) {
+        for(from = MIN_MAP_LOCATION; from <= MAX_MAP_LOCATION; from++) {
+            int *dist = cost[from];
+            int done[NUM_MAP_LOCATIONS] = {0};
+            int i;
+            for(i = 0; i < NUM_MAP_LOCATIONS; i++) dist[i] = UNSEEN;
+
+            resetHeap(h);
+            dist[from] = 0;
+            enterHeap(h, from, 0);
+            while(!emptyHeap(h)) {
+                int d;
+                LocationID at = leaveHeap(h, &d);
+                done[at] = TRUE;
+                for(i = 0; i < e->numEdges[at]; i++) {
+                    LocationID to = e->to[at][i];
+                    int nd = d + stepCost(to);
+                    if(done[to] || (dist[to] != UNSEEN && dist[to] <= nd)) continue;
+                    dist[to] = nd;
+                    enterHeap(h, to, nd);
+                }
+            }
+        }
+    }
+
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+static double dijkstraBuckets(Edges *e, int reps, int cost[NUM_MAP_LOCATIONS][NUM_MAP_LOCATIONS]) {
+    int storage[BUCKET_QUEUE_WORDS(NUM_MAP_LOCATIONS, MAX_STEP)];
+    BucketQueue b = bucketQueueIn(storage, NUM_MAP_LOCATIONS, MAX_STEP);
+
+    clock_t start = clock();
+    int r;
+    LocationID from;
+    for(r = 0; r < reps; r++) {
+        for(from = MIN_MAP_LOCATION; from <= MAX_MAP_LOCATION; from++) {
+            int *dist = cost[from];
+            int done[NUM_MAP_LOCATIONS] = {0};
+            int i;
+            for(i = 0; i < NUM_MAP_LOCATIONS; i++) dist[i] = UNSEEN;
+
+            resetBucketQueue(b);
+            dist[from] = 0;
+            enterBucketQueue(b, from, 0);
+            while(!emptyBucketQueue(b)) {
+                int d;
+                LocationID at = leaveBucketQueue(b, &d);
+                done[at] = TRUE;
+                for(i = 0; i < e->numEdges[at]; i++) {
+                    LocationID to = e->to[at][i];
+                    int nd = d + stepCost(to);
+                    if(done[to] || (dist[to] != UNSEEN && dist[to] <= nd)) continue;
+                    dist[to] = nd;
+                    enterBucketQueue(b, to, nd);
+                }
+            }
+        }
+    }
+
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
@@ -0,0 +1,172 @@
+// benchParse.c ... time building views from full-length games
+//
+// Pulls every "pastPlays" string out of the given game logs, keeps the
+// longest games and times newGameView() on them, and newDracView() on the
+// longest ones that show where Dracula went (hunters' logs hide his moves).
+// Then times cloning those views, alone and with a play tried on the clone,
+// and scanPlays() checking and decoding the games without making any plays.
+// Usage: ./benchParse [-r repetitions] GameLog/*.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "GameView.h"
+#include "DracView.h"
+#include "LogReader.h"
+
+#define DEFAULT_REPS 200
+#define CLONES_PER_REP 1000          // clones of each view per repetition
+#define SCANS_PER_REP 10             // scans of each game per repetition
+#define NUM_GAMES 16                 // how many of the longest games to time
+
+typedef struct games {
+    char *longest[NUM_GAMES];       // longest first
+    int numGames;
+} Games;
+
+static Games anyGames, dracGames;
+static PlayerMessage messages[MAX_PLAYS];
+
+static void keepGames(char *fileName);
+static void keepGame(char *pastPlays, int length, void *arg);
+static void keepIfLong(Games *games, char *start, int length);
+static void timeGames(Games *games, int reps, int dracView);
+static void timeClones(Games *games, int reps, int tryPlay);
+static void timeScans(Games *games, int reps);
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS;
+    int i = 1;
+    if(argc > 2 && strcmp(argv[1], "-r") == 0) {
+        reps = atoi(argv[2]);
+        i = 3;
+    }
+    assert(reps > 0);
+    if(i >= argc) {
+        fprintf(stderr, "Usage: %s [-r repetitions] log...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    forEachLog(argc - i, argv + i, keepGames);
+    assert(anyGames.numGames > 0 && dracGames.numGames > 0);
+
+    timeGames(&anyGames, reps, FALSE);
+    timeClones(&dracGames, reps, FALSE);
+    timeClones(&dracGames, reps, TRUE);
+    timeScans(&dracGames, reps);
+    timeGames(&dracGames, reps, TRUE);
+
+    return EXIT_SUCCESS;
+}
+
+// Finds every pastPlays string in a log
+static void keepGames(char *fileName) {
+    readLog(fileName, keepGame, NULL);
+}
+
+static void keepGame(char *pastPlays, int length, void *arg) {
+    keepIfLong(&anyGames, pastPlays, length);
+    if(strstr(pastPlays, "DC?") == NULL && strstr(pastPlays, "DS?") == NULL) {
+        keepIfLong(&dracGames, pastPlays, length);
+    }
+}
+
+// Keeps the NUM_GAMES longest games seen so far
+static void keepIfLong(Games *games, char *start, int length) {
+    int n = games->numGames;
+    if(n == NUM_GAMES && length <= strlen(games->longest[n - 1])) return;
+    if(n == NUM_GAMES) free(games->longest[--n]);
+
+    char *game = malloc(length + 1);
+    assert(game != NULL);
+    memcpy(game, start, length + 1);
+
+    int i;
+    for(i = n; i > 0 && strlen(games->longest[i - 1]) < length; i--) {
+        games->longest[i] = games->longest[i - 1];
+    }
+    games->longest[i] = game;
+    games->numGames = n + 1;
+}
+
+// Builds and disposes a view of each game reps times, then frees the games
+static void timeGames(Games *games, int reps, int dracView) {
+    long plays = 0;
+    int i, r;
+    for(i = 0; i < games->numGames; i++) plays += (strlen(games->longest[i]) + 1) / PLAY_LENGTH;
+    plays *= reps;
+
+    clock_t start = clock();
+    for(r = 0; r < reps; r++) {
+        for(i = 0; i < games->numGames; i++) {
+            if(dracView) {
+                disposeDracView(newDracView(games->longest[i], messages));
+            } else {
+                disposeGameView(newGameView(games->longest[i], messages));
+            }
+        }
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%s %2d games of %4d-%4d plays: %8.3f s  %10.0f plays/s\n",
+           dracView ? "newDracView" : "newGameView", games->numGames,
+           (int) (strlen(games->longest[games->numGames - 1]) + 1) / PLAY_LENGTH,
+           (int) (strlen(games->longest[0]) + 1) / PLAY_LENGTH, seconds, plays / seconds);
+
+    for(i = 0; i < games->numGames; i++) free(games->longest[i]);
+}
+
+// Clones a DracView of each game CLONES_PER_REP times per repetition,
+// trying the game's last play again on each clone if tryPlay
+static void timeClones(Games *games, int reps, int tryPlay) {
+    DracView views[NUM_GAMES];
+    char *lastPlay[NUM_GAMES];
+    int i, r, c;
+    for(i = 0; i < games->numGames; i++) {
+        views[i] = newDracView(games->longest[i], messages);
+        lastPlay[i] = games->longest[i] + strlen(games->longest[i]) - (PLAY_LENGTH - 1);
+    }
+
+    clock_t start = clock();
+    for(r = 0; r < reps; r++) {
+        for(i = 0; i < games->numGames; i++) {
+            for(c = 0; c < CLONES_PER_REP; c++) {
+                DracView clone = cloneDracView(views[i]);
+                if(tryPlay) updateDracView(clone, lastPlay[i]);
+                disposeDracView(clone);
+            }
+        }
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    double clones = (double) reps * games->numGames * CLONES_PER_REP;
+
+    printf("%-27s %8.3f s  %10.1f ns/clone\n",
+           tryPlay ? "cloneDracView + one play" : "cloneDracView", seconds, seconds * 1e9 / clones);
+
+    for(i = 0; i < games->numGames; i++) disposeDracView(views[i]);
+}
+
+// Checks and decodes each game SCANS_PER_REP times per repetition
+static void timeScans(Games *games, int reps) {
+    static DecodedPlay decoded[MAX_PLAYS];
+    long plays = 0;
+    int i, r, c;
+    for(i = 0; i < games->numGames; i++) plays += (strlen(games->longest[i]) + 1) / PLAY_LENGTH;
+
+    clock_t start = clock();
+    for(r = 0; r < reps; r++) {
+        for(i = 0; i < games->numGames; i++) {
+            int length = strlen(games->longest[i]);
+            for(c = 0; c < SCANS_PER_REP; c++) {
+                int numDecoded = scanPlays(games->longest[i], length, decoded);
+                assert(numDecoded > 0);
+            }
+        }
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    double scanned = (double) plays * reps * SCANS_PER_REP;
+
+    printf("%-27s %8.3f s  %10.0f plays/s\n", "scanPlays", seconds, scanned / seconds);
+}
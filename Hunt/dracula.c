@@ -11,6 +11,7 @@
 #include "Game.h"
 #include "Places.h"
 #include "Queue.h"
+#include "Random.h"
 #include "DracView.h"
 
 #define TRUE 1
@@ -20,28 +21,28 @@
 #define SAFE_DISTANCE 4
 
 // ***  Private Functions   ***
-static int isLegalMove(DracView gameState, LocationID move);
+static int isLegalMove(DracView gameState, const ViewState *state, LocationID move);
 static int isFound(LocationID *array, LocationID location, int low, int high);
 static int isAdjacent(DracView gameState, LocationID location);
-static int isSafeCastle(DracView gameState);
-static int hasDBInTrail(DracView gameState);
-static int numHuntersThere(DracView gameState, LocationID loc);
+static int isSafeCastle(DracView gameState, const ViewState *state);
+static int hasDBInTrail(const ViewState *state);
+static int numHuntersThere(const ViewState *state, LocationID loc);
 static int *occupiedPlaces(DracView gameState);
 //static int *distanceFromHunters(DracView gameState, LocationID *array, int n);
 
 static LocationID firstMove(DracView gameState);
-static LocationID BestMove(DracView gameState);
-static LocationID legalMove(DracView gameState);
-static LocationID goToLandOrSea(DracView gameState);
-static LocationID backToCastle(DracView gameState);
-static LocationID awayFromHunters(DracView gameState);
-static LocationID doubleBackToSafeLoc(DracView gameState);
+static LocationID BestMove(DracView gameState, const ViewState *state, Random *random);
+static LocationID legalMove(DracView gameState, const ViewState *state, Random *random);
+static LocationID goToLandOrSea(DracView gameState, const ViewState *state, Random *random);
+static LocationID backToCastle(DracView gameState, const ViewState *state, Random *random);
+static LocationID awayFromHunters(DracView gameState, const ViewState *state, Random *random);
+static LocationID doubleBackToSafeLoc(DracView gameState, const ViewState *state);
 //static LocationID positionInTrail(DracView gameState, LocationID location);
 static LocationID *connectedPorts(DracView gameState, int *numPorts);
-static LocationID *safeConnectedLocations(DracView gameState, int *numLocations, int road, int sea);
+static LocationID *safeConnectedLocations(DracView gameState, const ViewState *state,
+                                          int *numLocations, int road, int sea);
 
 static void sortLocIDArray(LocationID *array, int low, int high);
-static void moveToAbbreviation(LocationID move, char *abbrev);
 
 
 // Function to decide the move of Dracula
@@ -51,13 +52,16 @@ void decideDraculaMove(DracView gameState) {
     // For indentation in the game log
     printf("\n\n");
 
-    int i = 0;
-    Round round = giveMeTheRound(gameState); 
+    // Take the state once here and pass it down to every helper
+    ViewState state;
+    giveMeTheState(gameState, &state);
     LocationID move = UNKNOWN_LOCATION;
+    Random random;
+    seedRandom(&random, time(NULL));
    
-    if(round > 0) {     
+    if(state.round > 0) {     
         // Determine the best move depending on the current state of the game
-        move = BestMove(gameState);
+        move = BestMove(gameState, &state, &random);
     } else {
         // Move in first round (i.e: Round 0)
         move = firstMove(gameState);
@@ -66,20 +70,18 @@ void decideDraculaMove(DracView gameState) {
     
     // Send the move to the game engine after converting the move
     // into string (with two characters)
-    char abbrev[2];
-    for(i = 0; i <= 2; i++) abbrev[i] = '\0';
     if(move == UNKNOWN_LOCATION) move = TELEPORT;
-    moveToAbbreviation(move, abbrev);
+    PlayerMessage message = "Hunters, Listen and Obey!";
 
-    registerBestPlay(abbrev, "Hunters, Listen and Obey!");
+    registerBestPlay(idToAbbrev(move), message);
 }
 
 
 
 // ***   Private Functions   ***
 // Determine whether the given move is legal or not
-static int isLegalMove(DracView gameState, LocationID move) {
-    assert(gameState != NULL);
+static int isLegalMove(DracView gameState, const ViewState *state, LocationID move) {
+    assert(gameState != NULL && state != NULL);
 
     // Unknown moves = illegal
     if(move < MIN_MAP_LOCATION || (move > MAX_MAP_LOCATION && move < HIDE) ||
@@ -89,21 +91,16 @@ static int isLegalMove(DracView gameState, LocationID move) {
     }
    
     // As Dracula can go anywhere except hospital in the first round of the game
-    if(giveMeTheRound(gameState) == 0) {
+    if(state->round == 0) {
         if(move != ST_JOSEPH_AND_ST_MARYS && (move >= MIN_MAP_LOCATION && move <= MAX_MAP_LOCATION)) {
             return TRUE;
         }
     }
 
  
-    // Get Dracula's moves -- including special moves (DB?/HI/TP)
-    LocationID dracMoves[TRAIL_SIZE];
+    // Dracula's moves -- including special moves (DB?/HI/TP)
+    const LocationID *dracMoves = state->moves[PLAYER_DRACULA];
     int i = 0;
-    for(i = 0; i < TRAIL_SIZE; i++) {
-        dracMoves[i] = UNKNOWN_LOCATION;
-    }
-
-    giveMeTheMoves(gameState, PLAYER_DRACULA, dracMoves);
 
 
     if(move >= MIN_MAP_LOCATION && move <= MAX_MAP_LOCATION) {
@@ -123,11 +120,11 @@ static int isLegalMove(DracView gameState, LocationID move) {
         if(isAdjacent(gameState, move) == FALSE) return FALSE;
  
     } else if(move >= DOUBLE_BACK_1 && move <= DOUBLE_BACK_5) {
-        Round round = giveMeTheRound(gameState);
+        Round round = state->round;
 
         // Double back to an unknown location
         if(move - DOUBLE_BACK_1 >= round) return FALSE;
-        if(hasDBInTrail(gameState)) return FALSE;
+        if(hasDBInTrail(state)) return FALSE;
 
         // Find out where Dracula doubled back to
         int pos = move - DOUBLE_BACK_1;
@@ -158,7 +155,7 @@ static int isLegalMove(DracView gameState, LocationID move) {
         }
 
         // Dracula cannot hide at sea
-        LocationID currLoc = whereIs(gameState, PLAYER_DRACULA);
+        LocationID currLoc = state->location[PLAYER_DRACULA];
         if(idToType(currLoc) == SEA) return FALSE;
     }
 
@@ -192,33 +189,35 @@ static LocationID firstMove(DracView gameState) {
 } 
 
 // Determine the best move according to the current game state
-static LocationID BestMove(DracView gameState) {
-    assert(gameState != NULL);
+static LocationID BestMove(DracView gameState, const ViewState *state, Random *random) {
+    assert(gameState != NULL && state != NULL);
 
     LocationID move = UNKNOWN_LOCATION;   
  
-    if(idToType(whereIs(gameState, PLAYER_DRACULA)) == SEA) { 
+    if(idToType(state->location[PLAYER_DRACULA]) == SEA) { 
         // when Dracula is at sea
-        move = goToLandOrSea(gameState);
+        move = goToLandOrSea(gameState, state, random);
     } else {
-        if(isSafeCastle(gameState)) {
+        if(isSafeCastle(gameState, state)) {
             // Go back to his castle and gain 10HP 
             // if the castle is so called 'safe'
-            move = backToCastle(gameState);
+            move = backToCastle(gameState, state, random);
         } else {
             // Escape 
-            move = awayFromHunters(gameState);
+            move = awayFromHunters(gameState, state, random);
         }
     }   
 
-    if(move == UNKNOWN_LOCATION) move = legalMove(gameState);
+    if(move == UNKNOWN_LOCATION) move = legalMove(gameState, state, random);
     
     return move;
 }
 
 // Function to Legal (priority) move
-static LocationID legalMove(DracView gameState) {
-    assert(gameState != NULL);
+static LocationID legalMove(DracView gameState, const ViewState *state, Random *random) {
+    assert(gameState != NULL && state != NULL);
+
+    // Everything the legality checks below look at, taken once
 
     // Find out where Dracula can go
     int numLocations = 0;
@@ -236,7 +235,7 @@ static LocationID legalMove(DracView gameState) {
     for(i = 0; i < numLocations; i++) {
         LocationID v = connLoc[i];
 
-        if(isLegalMove(gameState, v)) {
+        if(isLegalMove(gameState, state, v)) {
             legalMoves[numLM++] = v;
         }    
     }
@@ -292,7 +291,7 @@ static LocationID legalMove(DracView gameState) {
                 LocationID v = legalMoves[i];
 
                 if(v == CASTLE_DRACULA) {
-                    if(!isSafeCastle(gameState)) continue;
+                    if(!isSafeCastle(gameState, state)) continue;
                 }
 
                 if(occupied[v] == risk) {
@@ -304,18 +303,16 @@ static LocationID legalMove(DracView gameState) {
         }
 
 
-        if(!hasDBInTrail(gameState)) {
+        if(!hasDBInTrail(state)) {
             printf("Try to use Double Back to escape from tracking\n\n");
 
-            LocationID trail[TRAIL_SIZE];
-            for(i = 0; i < TRAIL_SIZE; i++) trail[i] = UNKNOWN_LOCATION;
-            giveMeTheTrail(gameState, PLAYER_DRACULA, trail);
+            const LocationID *trail = state->trail[PLAYER_DRACULA];
 
             for(i = 0; i < TRAIL_SIZE - 1; i++) {
                 LocationID v = trail[i];
                 LocationID double_back = DOUBLE_BACK_1 + i;
                         
-                if(isLegalMove(gameState, double_back) && v != UNKNOWN_LOCATION) {
+                if(isLegalMove(gameState, state, double_back) && v != UNKNOWN_LOCATION) {
                     if(occupied[v] < risk) {
                         move = double_back;
                     }
@@ -325,18 +322,18 @@ static LocationID legalMove(DracView gameState) {
  
             // Try to use HIDE instead of DOUBLE_BACK_1
             if(move == DOUBLE_BACK_1) {
-                if(isLegalMove(gameState, HIDE)) move = HIDE;
+                if(isLegalMove(gameState, state, HIDE)) move = HIDE;
             } 
         } else {
 
             // Try to stay at the same location and use traps 
             // to kill hunters before the encounter
-            LocationID currLoc = whereIs(gameState, PLAYER_DRACULA);
+            LocationID currLoc = state->location[PLAYER_DRACULA];
             if(occupied[currLoc] <= risk) {
-                if(isLegalMove(gameState, currLoc)) {
+                if(isLegalMove(gameState, state, currLoc)) {
                     printf("Place more millions / Stay at the same sea ......\n\n");
                     move = currLoc;
-                } else if(isLegalMove(gameState, HIDE)) {
+                } else if(isLegalMove(gameState, state, HIDE)) {
                     printf("Place more millions / Stay at the same sea ......\n\n");
                     move = HIDE;
                 }  
@@ -347,16 +344,13 @@ static LocationID legalMove(DracView gameState) {
         // Make sure there is at least a legal move
         if(move == UNKNOWN_LOCATION) {
             printf("Bug! :(\n\n");
-            srand(time(NULL));
-            move = legalMoves[rand() % numLM];
+            move = legalMoves[randomIndex(random, numLM)];
         }
     } else {
 
         // If DB/HI are possible actions for Dracula only 
-        if(!hasDBInTrail(gameState)) {
-            LocationID trail[TRAIL_SIZE];
-            for(i = 0; i < TRAIL_SIZE; i++) trail[i] = UNKNOWN_LOCATION;
-            giveMeTheTrail(gameState, PLAYER_DRACULA, trail);
+        if(!hasDBInTrail(state)) {
+            const LocationID *trail = state->trail[PLAYER_DRACULA];
 
             int risk = 0;
             for(risk = 0; risk < NUM_PLAYERS; risk++) {
@@ -364,7 +358,7 @@ static LocationID legalMove(DracView gameState) {
                     LocationID v = trail[i];
                     LocationID double_back = DOUBLE_BACK_1 + i;
                         
-                    if(isLegalMove(gameState, double_back) && v != UNKNOWN_LOCATION) {
+                    if(isLegalMove(gameState, state, double_back) && v != UNKNOWN_LOCATION) {
                         if(occupied[v] == risk) move = double_back;
                     }
                 }
@@ -372,12 +366,12 @@ static LocationID legalMove(DracView gameState) {
           
             // Try to use HIDE instead of DOUBLE_BACK_1
             if(move == DOUBLE_BACK_1) {
-                if(isLegalMove(gameState, HIDE)) move = HIDE;
+                if(isLegalMove(gameState, state, HIDE)) move = HIDE;
             } 
 
             // Make sure there is at least a legal Double back
             if(move == UNKNOWN_LOCATION) move = DOUBLE_BACK_1;
-        } else if(isLegalMove(gameState, HIDE)) {
+        } else if(isLegalMove(gameState, state, HIDE)) {
             move = HIDE;
         } else {
             // There is no legal moves and Dracula will be 
@@ -392,9 +386,9 @@ static LocationID legalMove(DracView gameState) {
 
 // Determine whether Dracula should go to a 'safe' port city
 // or escape from hunters
-static LocationID goToLandOrSea(DracView gameState) {
-    assert(gameState != NULL);
-    assert(idToType(whereIs(gameState, PLAYER_DRACULA)) == SEA);
+static LocationID goToLandOrSea(DracView gameState, const ViewState *state, Random *random) {
+    assert(gameState != NULL && state != NULL);
+    assert(idToType(state->location[PLAYER_DRACULA]) == SEA);
    
         
     // Find out all the connected port cities     
@@ -425,13 +419,13 @@ static LocationID goToLandOrSea(DracView gameState) {
         }
 
         if(p == CAGLIARI) {
-            if(numHuntersThere(gameState, MEDITERRANEAN_SEA) > 0) continue; 
-            if(numHuntersThere(gameState, TYRRHENIAN_SEA) > 0)    continue;
+            if(numHuntersThere(state, MEDITERRANEAN_SEA) > 0) continue; 
+            if(numHuntersThere(state, TYRRHENIAN_SEA) > 0)    continue;
         }   
 
         if(p == GALWAY || p == DUBLIN) { 
-            if(numHuntersThere(gameState, IRISH_SEA) > 0)       continue;
-            if(numHuntersThere(gameState, ATLANTIC_OCEAN) > 0)  continue;
+            if(numHuntersThere(state, IRISH_SEA) > 0)       continue;
+            if(numHuntersThere(state, ATLANTIC_OCEAN) > 0)  continue;
         }
 
         if(p == EDINBURGH || p == LIVERPOOL || p == LONDON ||  
@@ -439,7 +433,7 @@ static LocationID goToLandOrSea(DracView gameState) {
         {
             if(occupied[LONDON])  continue;
             if(occupied[MANCHESTER]) continue;
-            if(numHuntersThere(gameState, ENGLISH_CHANNEL) > 0) continue;
+            if(numHuntersThere(state, ENGLISH_CHANNEL) > 0) continue;
         }
 
         if(!occupied[p]) safePorts[numSP++] = p;
@@ -451,9 +445,8 @@ static LocationID goToLandOrSea(DracView gameState) {
 
     LocationID move = UNKNOWN_LOCATION;
 
-    if(numSP > 0 && numHuntersThere(gameState, whereIs(gameState, PLAYER_DRACULA)) == 0) {
-        srand(time(NULL));    
-        int index = rand() % numSP;
+    if(numSP > 0 && numHuntersThere(state, state->location[PLAYER_DRACULA]) == 0) {
+        int index = randomIndex(random, numSP);
 
         printf("Landing ......\n\n");
         printf("Number of Safe ports: %d\n", numSP);
@@ -465,7 +458,7 @@ static LocationID goToLandOrSea(DracView gameState) {
         printf("\n");
 
         move = safePorts[index];
-        assert(isLegalMove(gameState, move)); 
+        assert(isLegalMove(gameState, state, move)); 
     } else {
         printf("Unable to Land :( ......\n\n");
         
@@ -479,7 +472,7 @@ static LocationID goToLandOrSea(DracView gameState) {
  
  
         for(hunter = 0; hunter < PLAYER_DRACULA; hunter++) {
-            if(idToType(whereIs(gameState, hunter)) == SEA) continue;
+            if(idToType(state->location[hunter]) == SEA) continue;
 
             int numLocations = 0;
             LocationID *adLoc = whereHuntersCanGoNext(gameState, &numLocations, hunter, 0, 0, 1);
@@ -508,15 +501,15 @@ static LocationID goToLandOrSea(DracView gameState) {
             if(idToType(v) != SEA) continue;
             
             if(v == ADRIATIC_SEA) {
-                if(numHuntersThere(gameState, IONIAN_SEA) > 0) continue;
+                if(numHuntersThere(state, IONIAN_SEA) > 0) continue;
             }
 
             if(v == IRISH_SEA) {
-                if(numHuntersThere(gameState, ATLANTIC_OCEAN) > 0) continue;
+                if(numHuntersThere(state, ATLANTIC_OCEAN) > 0) continue;
             }
 
-            if(numHuntersThere(gameState, v) == 0 && !occupiedSeas[v] && 
-               isLegalMove(gameState, v)) 
+            if(numHuntersThere(state, v) == 0 && !occupiedSeas[v] && 
+               isLegalMove(gameState, state, v)) 
             {
                 safeSeas[nSafeSeas++] = v;
             }
@@ -536,20 +529,19 @@ static LocationID goToLandOrSea(DracView gameState) {
 
 
         if(nSafeSeas > 0) {
-            srand(time(NULL));
-            int index = rand() % nSafeSeas; 
+            int index = randomIndex(random, nSafeSeas); 
 
             move = safeSeas[index];
-            assert(isLegalMove(gameState, move));
-        } else if(!hasDBInTrail(gameState)) {
+            assert(isLegalMove(gameState, state, move));
+        } else if(!hasDBInTrail(state)) {
             printf("Try to stay at the same sea if the current sea is safe :( ......\n\n");
-            move = doubleBackToSafeLoc(gameState);
+            move = doubleBackToSafeLoc(gameState, state);
         }
 
     }
  
  
-    if(move == UNKNOWN_LOCATION) move = legalMove(gameState);
+    if(move == UNKNOWN_LOCATION) move = legalMove(gameState, state, random);
 
     return move;
 }
@@ -586,14 +578,14 @@ static LocationID *connectedPorts(DracView gameState, int *numPorts) {
 
 // Determine what to do next in order to go back to Castle Dracula
 // Note: shortest Path
-static LocationID backToCastle(DracView gameState) {
-    assert(gameState != NULL);
+static LocationID backToCastle(DracView gameState, const ViewState *state, Random *random) {
+    assert(gameState != NULL && state != NULL);
 
     // If Dracula is already in his castle
-    LocationID curr = whereIs(gameState, PLAYER_DRACULA);
-    if(curr == CASTLE_DRACULA && isLegalMove(gameState, HIDE) == TRUE) {
+    LocationID curr = state->location[PLAYER_DRACULA];
+    if(curr == CASTLE_DRACULA && isLegalMove(gameState, state, HIDE) == TRUE) {
         return HIDE;
-    } else if(curr == CASTLE_DRACULA && isLegalMove(gameState, DOUBLE_BACK_1) == TRUE) {
+    } else if(curr == CASTLE_DRACULA && isLegalMove(gameState, state, DOUBLE_BACK_1) == TRUE) {
         return DOUBLE_BACK_1;
     }
 
@@ -608,12 +600,12 @@ static LocationID backToCastle(DracView gameState) {
         assert(sPath != NULL);
         LocationID next = sPath[1];
       
-        if(isLegalMove(gameState, next)) {
+        if(isLegalMove(gameState, state, next)) {
             printf("(`vv`) --> Castle Dracula\n\n");
 
             move = next;
         } else {
-            move = awayFromHunters(gameState);
+            move = awayFromHunters(gameState, state, random);
         } 
              
         free(sPath);
@@ -621,25 +613,25 @@ static LocationID backToCastle(DracView gameState) {
     } else {
         
         // Escape when there is no shortest path
-        move = awayFromHunters(gameState);
+        move = awayFromHunters(gameState, state, random);
     }
 
 
     // Make sure that Dracula takes a random and of course a legal move
     if(move == UNKNOWN_LOCATION) {
-        move = legalMove(gameState);
+        move = legalMove(gameState, state, random);
     }
 
     return move;
 }
 
 // Determine move which will make Dracula moves away from hunters
-static LocationID awayFromHunters(DracView gameState) {
-    assert(gameState != NULL);
+static LocationID awayFromHunters(DracView gameState, const ViewState *state, Random *random) {
+    assert(gameState != NULL && state != NULL);
 
     // Discover where hunters can't reach while Dracula can reach
     int numSL = 0;
-    LocationID *safeLoc = safeConnectedLocations(gameState, &numSL, 1, 0);
+    LocationID *safeLoc = safeConnectedLocations(gameState, state, &numSL, 1, 0);
     assert(safeLoc != NULL);  
     
     // For the game Log
@@ -659,26 +651,25 @@ static LocationID awayFromHunters(DracView gameState) {
     if(numSL > 0) {
         printf("Going to safe spot ......\n");
        
-        srand(time(NULL));         
-        int index = rand() % numSL;
+        int index = randomIndex(random, numSL);
 
         move = safeLoc[index];
-        assert(isLegalMove(gameState, move));
+        assert(isLegalMove(gameState, state, move));
     } else {
  
-        if(!hasDBInTrail(gameState)) {
-            move = doubleBackToSafeLoc(gameState);
+        if(!hasDBInTrail(state)) {
+            move = doubleBackToSafeLoc(gameState, state);
 
             if(move == DOUBLE_BACK_1) {
-                if(isLegalMove(gameState, HIDE)) {
+                if(isLegalMove(gameState, state, HIDE)) {
                     move = HIDE;
                 }
             }
-        } else if(isLegalMove(gameState, HIDE)) {
+        } else if(isLegalMove(gameState, state, HIDE)) {
             int *occupied = occupiedPlaces(gameState);
             assert(occupied != NULL);
 
-            LocationID currLoc = whereIs(gameState, PLAYER_DRACULA);
+            LocationID currLoc = state->location[PLAYER_DRACULA];
             if(!occupied[currLoc]) move = HIDE;
             free(occupied);
         } 
@@ -686,14 +677,13 @@ static LocationID awayFromHunters(DracView gameState) {
         if(move == UNKNOWN_LOCATION) {
             free(safeLoc);         
 
-            safeLoc = safeConnectedLocations(gameState, &numSL, 1, 1);
+            safeLoc = safeConnectedLocations(gameState, state, &numSL, 1, 1);
             assert(safeLoc != NULL);
      
             if(numSL > 0) {
                 printf("Try to escape by sea travel ......\n\n");
 
-                srand(time(NULL));
-                move = safeLoc[rand() % numSL];
+                move = safeLoc[randomIndex(random, numSL)];
             }
         }
 
@@ -703,20 +693,19 @@ static LocationID awayFromHunters(DracView gameState) {
     free(safeLoc);
 
     // Make sure Dracula will make a random and legal move
-    if(move == UNKNOWN_LOCATION) move = legalMove(gameState);    
+    if(move == UNKNOWN_LOCATION) move = legalMove(gameState, state, random);    
 
     return move;
 }
 
 // Use Double back to go to safe Location
-static LocationID doubleBackToSafeLoc(DracView gameState) {
-    assert(gameState != NULL);
-    assert(!hasDBInTrail(gameState));    
+static LocationID doubleBackToSafeLoc(DracView gameState, const ViewState *state) {
+    assert(gameState != NULL && state != NULL);
+    assert(!hasDBInTrail(state));    
 
     LocationID move = UNKNOWN_LOCATION;
 
-    LocationID trail[TRAIL_SIZE];
-    giveMeTheTrail(gameState, PLAYER_DRACULA, trail);
+    const LocationID *trail = state->trail[PLAYER_DRACULA];
 
     int i = 0;
     int *occupied = occupiedPlaces(gameState);
@@ -726,11 +715,11 @@ static LocationID doubleBackToSafeLoc(DracView gameState) {
         LocationID loc = trail[i];
 
         if(loc == CASTLE_DRACULA) {
-            if(!isSafeCastle(gameState)) continue;
+            if(!isSafeCastle(gameState, state)) continue;
         }
 
         if(loc != UNKNOWN_LOCATION) {
-            if(!occupied[loc] && isLegalMove(gameState, DOUBLE_BACK_1 + i)) {
+            if(!occupied[loc] && isLegalMove(gameState, state, DOUBLE_BACK_1 + i)) {
                 printf("Double Back to safe spot ......\n\n");
 
                 move = DOUBLE_BACK_1 + i;
@@ -745,8 +734,9 @@ static LocationID doubleBackToSafeLoc(DracView gameState) {
 }
 
 // Find out places where are not connected to hunters' locations
-static LocationID *safeConnectedLocations(DracView gameState, int *numLocations, int road, int sea) {
-    assert(gameState != NULL);
+static LocationID *safeConnectedLocations(DracView gameState, const ViewState *state,
+                                          int *numLocations, int road, int sea) {
+    assert(gameState != NULL && state != NULL);
 
     // Initialise
     int i = 0;
@@ -773,11 +763,11 @@ static LocationID *safeConnectedLocations(DracView gameState, int *numLocations,
         LocationID v = connLoc[i];
  
         if(v == CASTLE_DRACULA) {
-            if(!isSafeCastle(gameState)) continue;
+            if(!isSafeCastle(gameState, state)) continue;
         }
 
 
-        if(isLegalMove(gameState, v)) {
+        if(isLegalMove(gameState, state, v)) {
             if(!occupied[v]) {
                 safePlaces[count++] = v;
             }
@@ -848,15 +838,11 @@ static int isAdjacent(DracView gameState, LocationID location) {
 }
 
 // Check whether there is double back in the trail
-static int hasDBInTrail(DracView gameState) {
-    assert(gameState != NULL);
+static int hasDBInTrail(const ViewState *state) {
+    assert(state != NULL);
 
-    LocationID dracMoves[TRAIL_SIZE];
-    
+    const LocationID *dracMoves = state->moves[PLAYER_DRACULA];
     int i = 0;
-    for(i = 0; i < TRAIL_SIZE; i++) dracMoves[i] = UNKNOWN_LOCATION;
-    giveMeTheMoves(gameState, PLAYER_DRACULA, dracMoves);
-
     for(i = 0; i < TRAIL_SIZE - 1; i++) {
         if(dracMoves[i] >= DOUBLE_BACK_1 && dracMoves[i] <= DOUBLE_BACK_5) {
             return TRUE;
@@ -868,13 +854,13 @@ static int hasDBInTrail(DracView gameState) {
 
 
 // Check how many hunters at the given location
-static int numHuntersThere(DracView gameState, LocationID loc) {
-    assert(gameState != NULL);
+static int numHuntersThere(const ViewState *state, LocationID loc) {
+    assert(state != NULL);
     assert(loc >= MIN_MAP_LOCATION && loc <= MAX_MAP_LOCATION);
 
     int i, num = 0;
     for(i = 0; i < PLAYER_DRACULA; i++) {
-        if(whereIs(gameState, i) == loc) num++;
+        if(state->location[i] == loc) num++;
     }
 
     return num;
@@ -883,45 +869,33 @@ static int numHuntersThere(DracView gameState, LocationID loc) {
 static int *occupiedPlaces(DracView gameState) {
     assert(gameState != NULL);
 
-    int i = 0;
-    int hunter = 0;   
     int *occupied = malloc(NUM_MAP_LOCATIONS * sizeof(int));
     assert(occupied != NULL);
-
-    for(i = 0; i < NUM_MAP_LOCATIONS; i++) occupied[i] = 0;
-    occupied[ST_JOSEPH_AND_ST_MARYS] = 1;
-  
  
     // Find where hunters can go in next round
-    for(hunter = 0; hunter < PLAYER_DRACULA; hunter++) {
-        int numLocations = 0;
-        LocationID *connLoc = whereHuntersCanGoNext(gameState, &numLocations, hunter, 1, 1, 1);
-        assert(connLoc != NULL);
-
-        for(i = 0; i < numLocations; i++) {
-            LocationID v = connLoc[i];
-            if(idToType(v) == SEA) continue;
+    LocationID v;
+    for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+        occupied[v] = 0;
+        if(idToType(v) == SEA) continue;
 
-            occupied[v] = 1;
-        }
-
-        free(connLoc);
+        if(huntersThreatening(gameState, v, 1)) occupied[v] = 1;
     }
+    occupied[ST_JOSEPH_AND_ST_MARYS] = 1;
 
     return occupied;
 }
 
 
 // Check whether the Castle Dracula is 'safe'
-static int isSafeCastle(DracView gameState) {
-    assert(gameState != NULL);
+static int isSafeCastle(DracView gameState, const ViewState *state) {
+    assert(gameState != NULL && state != NULL);
 
     int hunter = 0;
     int greaterThanSD = 0;
  
     for(hunter = 0; hunter < PLAYER_DRACULA; hunter++) {
         int length = 0;
-        LocationID *sPath = sPathForHunters(gameState, &length, hunter, whereIs(gameState, hunter),
+        LocationID *sPath = sPathForHunters(gameState, &length, hunter, state->location[hunter],
                                             CASTLE_DRACULA, 1, 1, 1); 
             
         assert(sPath != NULL);
@@ -934,7 +908,7 @@ static int isSafeCastle(DracView gameState) {
     }
 
     int distFromD = 0;
-    LocationID *sPath = shortestPath(gameState, &distFromD, whereIs(gameState, PLAYER_DRACULA),
+    LocationID *sPath = shortestPath(gameState, &distFromD, state->location[PLAYER_DRACULA],
                                      CASTLE_DRACULA, 1, 1);
    
     int isSafe = FALSE;
@@ -1018,114 +992,3 @@ static int isFound(LocationID *array, LocationID location, int low, int high) {
 
     return isFound;
 }
-
-// Function to turn the ID of given move to a two-character string
-static void moveToAbbreviation(LocationID move, char *abbrev) {
-    assert((move >= MIN_MAP_LOCATION && move <= MAX_MAP_LOCATION) || (move >= HIDE && move <= TELEPORT));
-    assert(abbrev != NULL);
-
-    switch(move) {
-    case ADRIATIC_SEA:             strcpy(abbrev, "AS");  break;
-    case ALICANTE:                 strcpy(abbrev, "AL");  break;
-    case AMSTERDAM:                strcpy(abbrev, "AM");  break;
-    case ATHENS:                   strcpy(abbrev, "AT");  break; 
-    case ATLANTIC_OCEAN:           strcpy(abbrev, "AO");  break;
-
-    case BARCELONA:                strcpy(abbrev, "BA");  break;
-    case BARI:                     strcpy(abbrev, "BI");  break;
-    case BAY_OF_BISCAY:            strcpy(abbrev, "BB");  break;
-    case BELGRADE:                 strcpy(abbrev, "BE");  break;
-    case BERLIN:                   strcpy(abbrev, "BR");  break;
-    case BLACK_SEA:                strcpy(abbrev, "BS");  break;
-    case BORDEAUX:                 strcpy(abbrev, "BO");  break;
-    case BRUSSELS:                 strcpy(abbrev, "BU");  break;
-    case BUCHAREST:                strcpy(abbrev, "BC");  break;
-    case BUDAPEST:                 strcpy(abbrev, "BD");  break;
-
-    case CADIZ:                    strcpy(abbrev, "CA");  break;
-    case CAGLIARI:                 strcpy(abbrev, "CG");  break;
-    case CASTLE_DRACULA:           strcpy(abbrev, "CD");  break;
-    case CLERMONT_FERRAND:         strcpy(abbrev, "CF");  break;
-    case COLOGNE:                  strcpy(abbrev, "CO");  break;
-    case CONSTANTA:                strcpy(abbrev, "CN");  break;
-
-    case DUBLIN:                   strcpy(abbrev, "DU");  break;
-    
-    case EDINBURGH:                strcpy(abbrev, "ED");  break;
-    case ENGLISH_CHANNEL:          strcpy(abbrev, "EC");  break;
-
-    case FLORENCE:                 strcpy(abbrev, "FL");  break;
-    case FRANKFURT:                strcpy(abbrev, "FR");  break;
-
-    case GALATZ:                   strcpy(abbrev, "GA");  break;
-    case GALWAY:                   strcpy(abbrev, "GW");  break;
-    case GENEVA:                   strcpy(abbrev, "GE");  break;
-    case GENOA:                    strcpy(abbrev, "GO");  break;
-    case GRANADA:                  strcpy(abbrev, "GR");  break;
-
-    case HAMBURG:                  strcpy(abbrev, "HA");  break;
-   
-    case IONIAN_SEA:               strcpy(abbrev, "IO");  break;
-    case IRISH_SEA:                strcpy(abbrev, "IR");  break;
-    
-    case KLAUSENBURG:              strcpy(abbrev, "KL");  break;
-   
-    case LEIPZIG:                  strcpy(abbrev, "LI");  break;
-    case LE_HAVRE:                 strcpy(abbrev, "LE");  break;
-    case LISBON:                   strcpy(abbrev, "LS");  break;
-    case LIVERPOOL:                strcpy(abbrev, "LV");  break;
-    case LONDON:                   strcpy(abbrev, "LO");  break;
-
-    case MADRID:                   strcpy(abbrev, "MA");  break;
-    case MANCHESTER:               strcpy(abbrev, "MN");  break;
-    case MARSEILLES:               strcpy(abbrev, "MR");  break;
-    case MEDITERRANEAN_SEA:        strcpy(abbrev, "MS");  break;
-    case MILAN:                    strcpy(abbrev, "MI");  break;
-    case MUNICH:                   strcpy(abbrev, "MU");  break;
-
-    case NANTES:                   strcpy(abbrev, "NA");  break;
-    case NAPLES:                   strcpy(abbrev, "NP");  break;
-    case NORTH_SEA:                strcpy(abbrev, "NS");  break;
-    case NUREMBURG:                strcpy(abbrev, "NU");  break;
-
-    case PARIS:                    strcpy(abbrev, "PA");  break;
-    case PLYMOUTH:                 strcpy(abbrev, "PL");  break;
-    case PRAGUE:                   strcpy(abbrev, "PR");  break;
-
-    case ROME:                     strcpy(abbrev, "RO");  break;
-
-    case SALONICA:                 strcpy(abbrev, "SA");  break;
-    case SANTANDER:                strcpy(abbrev, "SN");  break;
-    case SARAGOSSA:                strcpy(abbrev, "SR");  break;
-    case SARAJEVO:                 strcpy(abbrev, "SJ");  break;
-    case SOFIA:                    strcpy(abbrev, "SO");  break;
-    case ST_JOSEPH_AND_ST_MARYS:   strcpy(abbrev, "JM");  break;
-    case STRASBOURG:               strcpy(abbrev, "ST");  break;
-    case SWANSEA:                  strcpy(abbrev, "SW");  break;
-    case SZEGED:                   strcpy(abbrev, "SZ");  break;
-
-    case TOULOUSE:                 strcpy(abbrev, "TO");  break;
-    case TYRRHENIAN_SEA:           strcpy(abbrev, "TS");  break;
-
-    case VALONA:                   strcpy(abbrev, "VA");  break;
-    case VARNA:                    strcpy(abbrev, "VR");  break;
-    case VENICE:                   strcpy(abbrev, "VE");  break;
-    case VIENNA:                   strcpy(abbrev, "VI");  break;
-
-    case ZAGREB:                   strcpy(abbrev, "ZA");  break;
-    case ZURICH:                   strcpy(abbrev, "ZU");  break;
-
-    //Special Moves
-    case HIDE:                     strcpy(abbrev, "HI");  break;
-    case DOUBLE_BACK_1:            strcpy(abbrev, "D1");  break;
-    case DOUBLE_BACK_2:            strcpy(abbrev, "D2");  break;
-    case DOUBLE_BACK_3:            strcpy(abbrev, "D3");  break;
-    case DOUBLE_BACK_4:            strcpy(abbrev, "D4");  break;
-    case DOUBLE_BACK_5:            strcpy(abbrev, "D5");  break;
-    case TELEPORT:                 strcpy(abbrev, "TP");  break;
-
-    default: 
-        fprintf(stdout, "Location of hunter is unknown !!!\n");
-        exit(EXIT_FAILURE);
-    }
-}
@@ -11,6 +11,7 @@
 #include "Game.h"
 #include "Places.h"
 #include "Queue.h"
+#include "Random.h"
 #include "HunterView.h"
 #include "GameView.h"
 
@@ -25,27 +26,29 @@ static int isAdjacent(HunterView gameState, LocationID location);
 static int isFound(LocationID *array, LocationID location, int low, int high);
 
 static LocationID firstMove(HunterView gameState);
-static LocationID randomMove(HunterView gameState);
+static LocationID randomMove(HunterView gameState, Random *random);
 static LocationID Rest(HunterView gameState);
 
 static void sortLocIDArray(LocationID *array, int low, int high);
-static void moveToAbbreviation(LocationID move, char *abbrev);
 
-static LocationID BestMove(HunterView gameState);
+static LocationID BestMove(HunterView gameState, Random *random);
 
 void decideHunterMove(HunterView gameState)
 {
     assert(gameState != NULL);
 
     LocationID move = UNKNOWN_LOCATION;
-    Round round = giveMeTheRound(gameState);
+    Random random;
+    seedRandom(&random, time(NULL));
+    ViewState state;
+    giveMeTheState(gameState, &state);
 
-    if(round > 0) {
-        int health = howHealthyIs(gameState, whoAmI(gameState));
+    if(state.round > 0) {
+        int health = state.health[state.currentPlayer];
 
         if(health >= MIN_HEALTH) {
             //move = randomMove(gameState);
-	    move = BestMove(gameState);
+	    move = BestMove(gameState, &random);
         } else {
             move = Rest(gameState);
         }
@@ -54,15 +57,12 @@ void decideHunterMove(HunterView gameState)
     }
 
 
-    if(move == UNKNOWN_LOCATION) move = randomMove(gameState);
+    if(move == UNKNOWN_LOCATION) move = randomMove(gameState, &random);
     assert(move >= MIN_MAP_LOCATION && move <= MAX_MAP_LOCATION);
 
-    char abbrev[2];
-    int i = 0;
-    for(i = 0; i < 2; i++) abbrev[i] = '\0';
-    moveToAbbreviation(move, abbrev);         
+    PlayerMessage message = "Hi Dracula, your death descends HAHA";
 
-    registerBestPlay(abbrev, "Hi Dracula, your death descends HAHA");
+    registerBestPlay(idToAbbrev(move), message);
 }
 
 
@@ -91,7 +91,7 @@ static LocationID firstMove(HunterView gameState) {
     return move;
 }
 
-static LocationID randomMove(HunterView gameState) {
+static LocationID randomMove(HunterView gameState, Random *random) {
     assert(gameState != NULL);
 
     int numLocations = 0;
@@ -99,7 +99,6 @@ static LocationID randomMove(HunterView gameState) {
     assert(adLoc != NULL);   
     assert(numLocations > 0);
 
-    srand(time(NULL));
     LocationID move = adLoc[0];
 
     if(numLocations > 1) {
@@ -116,8 +115,7 @@ static LocationID randomMove(HunterView gameState) {
             }
         }
 
-        srand(time(NULL));
-        int index = rand() % count;
+        int index = randomIndex(random, count);
         move = diff[index];
         assert(move != whereIs(gameState, whoAmI(gameState)));     
     }
@@ -211,110 +209,8 @@ static int isFound(LocationID *array, LocationID location, int low, int high) {
 }
 
 
-// Convert the given move into a two-character string
-static void moveToAbbreviation(LocationID move, char *abbrev) {
-    assert(move >= MIN_MAP_LOCATION && move <= MAX_MAP_LOCATION);
-    assert(abbrev != NULL);
-
-    switch(move) {
-    case ADRIATIC_SEA:             strcpy(abbrev, "AS");  break;
-    case ALICANTE:                 strcpy(abbrev, "AL");  break;
-    case AMSTERDAM:                strcpy(abbrev, "AM");  break;
-    case ATHENS:                   strcpy(abbrev, "AT");  break; 
-    case ATLANTIC_OCEAN:           strcpy(abbrev, "AO");  break;
-
-    case BARCELONA:                strcpy(abbrev, "BA");  break;
-    case BARI:                     strcpy(abbrev, "BI");  break;
-    case BAY_OF_BISCAY:            strcpy(abbrev, "BB");  break;
-    case BELGRADE:                 strcpy(abbrev, "BE");  break;
-    case BERLIN:                   strcpy(abbrev, "BR");  break;
-    case BLACK_SEA:                strcpy(abbrev, "BS");  break;
-    case BORDEAUX:                 strcpy(abbrev, "BO");  break;
-    case BRUSSELS:                 strcpy(abbrev, "BU");  break;
-    case BUCHAREST:                strcpy(abbrev, "BC");  break;
-    case BUDAPEST:                 strcpy(abbrev, "BD");  break;
-
-    case CADIZ:                    strcpy(abbrev, "CA");  break;
-    case CAGLIARI:                 strcpy(abbrev, "CG");  break;
-    case CASTLE_DRACULA:           strcpy(abbrev, "CD");  break;
-    case CLERMONT_FERRAND:         strcpy(abbrev, "CF");  break;
-    case COLOGNE:                  strcpy(abbrev, "CO");  break;
-    case CONSTANTA:                strcpy(abbrev, "CN");  break;
-
-    case DUBLIN:                   strcpy(abbrev, "DU");  break;
-    
-    case EDINBURGH:                strcpy(abbrev, "ED");  break;
-    case ENGLISH_CHANNEL:          strcpy(abbrev, "EC");  break;
-
-    case FLORENCE:                 strcpy(abbrev, "FL");  break;
-    case FRANKFURT:                strcpy(abbrev, "FR");  break;
-
-    case GALATZ:                   strcpy(abbrev, "GA");  break;
-    case GALWAY:                   strcpy(abbrev, "GW");  break;
-    case GENEVA:                   strcpy(abbrev, "GE");  break;
-    case GENOA:                    strcpy(abbrev, "GO");  break;
-    case GRANADA:                  strcpy(abbrev, "GR");  break;
-
-    case HAMBURG:                  strcpy(abbrev, "HA");  break;
-   
-    case IONIAN_SEA:               strcpy(abbrev, "IO");  break;
-    case IRISH_SEA:                strcpy(abbrev, "IR");  break;
-    
-    case KLAUSENBURG:              strcpy(abbrev, "KL");  break;
-   
-    case LEIPZIG:                  strcpy(abbrev, "LI");  break;
-    case LE_HAVRE:                 strcpy(abbrev, "LE");  break;
-    case LISBON:                   strcpy(abbrev, "LS");  break;
-    case LIVERPOOL:                strcpy(abbrev, "LV");  break;
-    case LONDON:                   strcpy(abbrev, "LO");  break;
-
-    case MADRID:                   strcpy(abbrev, "MA");  break;
-    case MANCHESTER:               strcpy(abbrev, "MN");  break;
-    case MARSEILLES:               strcpy(abbrev, "MR");  break;
-    case MEDITERRANEAN_SEA:        strcpy(abbrev, "MS");  break;
-    case MILAN:                    strcpy(abbrev, "MI");  break;
-    case MUNICH:                   strcpy(abbrev, "MU");  break;
-
-    case NANTES:                   strcpy(abbrev, "NA");  break;
-    case NAPLES:                   strcpy(abbrev, "NP");  break;
-    case NORTH_SEA:                strcpy(abbrev, "NS");  break;
-    case NUREMBURG:                strcpy(abbrev, "NU");  break;
-
-    case PARIS:                    strcpy(abbrev, "PA");  break;
-    case PLYMOUTH:                 strcpy(abbrev, "PL");  break;
-    case PRAGUE:                   strcpy(abbrev, "PR");  break;
-
-    case ROME:                     strcpy(abbrev, "RO");  break;
-
-    case SALONICA:                 strcpy(abbrev, "SA");  break;
-    case SANTANDER:                strcpy(abbrev, "SN");  break;
-    case SARAGOSSA:                strcpy(abbrev, "SR");  break;
-    case SARAJEVO:                 strcpy(abbrev, "SJ");  break;
-    case SOFIA:                    strcpy(abbrev, "SO");  break;
-    case ST_JOSEPH_AND_ST_MARYS:   strcpy(abbrev, "JM");  break;
-    case STRASBOURG:               strcpy(abbrev, "ST");  break;
-    case SWANSEA:                  strcpy(abbrev, "SW");  break;
-    case SZEGED:                   strcpy(abbrev, "SZ");  break;
-
-    case TOULOUSE:                 strcpy(abbrev, "TO");  break;
-    case TYRRHENIAN_SEA:           strcpy(abbrev, "TS");  break;
-
-    case VALONA:                   strcpy(abbrev, "VA");  break;
-    case VARNA:                    strcpy(abbrev, "VR");  break;
-    case VENICE:                   strcpy(abbrev, "VE");  break;
-    case VIENNA:                   strcpy(abbrev, "VI");  break;
-
-    case ZAGREB:                   strcpy(abbrev, "ZA");  break;
-    case ZURICH:                   strcpy(abbrev, "ZU");  break;
-
-    default: 
-        fprintf(stdout, "Location of hunter is unknown !!!\n");
-        exit(EXIT_FAILURE);
-    }
 
-}
-
-static LocationID BestMove(HunterView gameState){
+static LocationID BestMove(HunterView gameState, Random *random){
 // essentially this tactic aims to check if any of the possible locations which the hunter can enter in is in draculas trail. 
 //If the hunter has the option to move to a locaiton which is in draculas trail then they do as they are then closer to dracula. 
 
@@ -328,11 +224,11 @@ static LocationID BestMove(HunterView gameState){
 	assert(adLoc != NULL);
 	assert(numLocations > 0);
 	
+	int i,j;
 	LocationID trail[TRAIL_SIZE];
         for(i = 0; i < TRAIL_SIZE; i++) trail[i] = UNKNOWN_LOCATION;
         giveMeTheTrail(gameState, PLAYER_DRACULA, trail);		// return an array of draculas trail
 
-	int i,j;
 	// check if any of the possible moves are in draculas trail
 	// if the location is in dracs trail then move to this location as hunter is then closer to dracula
 	for(i = 0; i < numLocations; i++){
@@ -345,5 +241,5 @@ static LocationID BestMove(HunterView gameState){
 		}
 	}
 	// if none of the possible moves are in dracs trail then just make a random move
-	return bestMove = randomMove(gameState);	
+	return bestMove = randomMove(gameState, random);	
 }
@@ -56,12 +56,8 @@ int main(int argc, char *argv[])
 
    char *plays = "GMR.... SMU.... HMI.... MZU.... DMA.V.. GTO.... SZA.... HRO.... MGE.... DALT... GBA.... SVI.... HBI.... MCF.... DGRT... GLS.... SBD.... HNP.... MBO.... DHIT... GCA.... SKL.... HFL.... MLE.... DD3T... GGRTT.. SBE.... HGO.... MEC.... DSRT... GALTT.. SSA.... HMR.... MAO....";
 
-   PlayerMessage msgs[1850];
-
-   int i = 0;
-   for(i = 0; i < 1850; i++) strcpy(msgs[i], "");
-
-   gameState = newDracView(plays,msgs);
+   // the views read messages in place: none here, so pass none
+   gameState = newDracView(plays, NULL);
    decideDraculaMove(gameState);
 
 
@@ -122,11 +118,9 @@ int main(int argc, char *argv[])
 #else
    HunterView gameState;
    char *plays = "GGE.... SKL...."; 
-   PlayerMessage msgs[1850];
    int i = 0;
-   for(i = 0; i < 1850; i++) strcpy(msgs[i], "");
 
-   gameState = newHunterView(plays,msgs);
+   gameState = newHunterView(plays, NULL);
 
    int length = 0;
    LocationID *sPath = shortestPath(gameState, &length, PLAYER_DR_SEWARD, KLAUSENBURG, SALONICA, 1, 1, 1);
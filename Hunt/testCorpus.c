@@ -0,0 +1,151 @@
+// testCorpus.c ... test reading positions from a mapped corpus file
+//
+// Reads every log given (or every log in GameLog/) both with the corpus
+// reader and line by line with readLog(), checking they find the same
+// positions, and that feeding one GameView through the corpus keeps it
+// the same as a view built from scratch at each position.
+// Usage: ./testCorpus [log...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "Globals.h"
+#include "GameView.h"
+#include "Corpus.h"
+#include "LogReader.h"
+
+// What testLog() has of a log so far, from both readers
+typedef struct logTest {
+    Corpus positions;
+    Corpus views;
+    GameView fed;
+    char last[MAX_PLAYS * PLAY_LENGTH];
+} LogTest;
+
+static int numPositions;
+
+static void testLog(char *fileName);
+static void testPosition(char *pastPlays, int length, void *arg);
+static void testOddFiles(void);
+static void assertSameGameView(GameView a, GameView b);
+
+int main(int argc, char *argv[]) {
+    printf("Test for reading a corpus\n");
+
+    forEachLog(argc - 1, argv + 1, testLog);
+    assert(numPositions > 0);
+    testOddFiles();
+
+    printf("passed (%d positions)\n", numPositions);
+    return EXIT_SUCCESS;
+}
+
+// The corpus reader against readLog(), position by position
+static void testLog(char *fileName) {
+    static LogTest test;
+    test.positions = openCorpus(fileName);
+    test.views = openCorpus(fileName);
+    assert(test.positions != NULL && test.views != NULL);
+    test.fed = NULL;
+    test.last[0] = '\0';
+
+    readLog(fileName, testPosition, &test);
+
+    Position position;
+    assert(!nextPosition(test.positions, &position));
+    assert(!nextPosition(test.positions, &position));
+    GameView before = test.fed;
+    assert(!feedGameView(test.views, &test.fed) && test.fed == before);
+
+    if(test.fed != NULL) disposeGameView(test.fed);
+    closeCorpus(test.positions);
+    closeCorpus(test.views);
+}
+
+// The next position from each corpus against the one readLog() found
+static void testPosition(char *pastPlays, int length, void *arg) {
+    LogTest *test = arg;
+    char *last = test->last;
+
+    Position position;
+    assert(nextPosition(test->positions, &position));
+    assert(position.length == length);
+    assert(memcmp(position.plays, pastPlays, position.length) == 0);
+
+    int carriesOn = last[0] != '\0' && strncmp(pastPlays, last, strlen(last)) == 0 &&
+                    (pastPlays[strlen(last)] == ' ' || pastPlays[strlen(last)] == '\0');
+    assert(position.shared == (carriesOn ? strlen(last) : 0));
+    strcpy(last, pastPlays);
+
+    assert(feedGameView(test->views, &test->fed));
+    GameView built = newGameView(pastPlays, NULL);
+    assertSameGameView(test->fed, built);
+    disposeGameView(built);
+    numPositions++;
+}
+
+// Empty and missing files, lines with no closing quote, and no final newline
+static void testOddFiles(void) {
+    assert(openCorpus("GameLog/no such log") == NULL);
+
+    char fileName[] = "/tmp/testCorpusXXXXXX";
+    FILE *f = fdopen(mkstemp(fileName), "w");
+    assert(f != NULL);
+    fclose(f);
+
+    Position position;
+    GameView view = NULL;
+    Corpus corpus = openCorpus(fileName);
+    assert(corpus != NULL && !nextPosition(corpus, &position));
+    assert(!nextPosition(corpus, &position));
+    assert(!feedGameView(corpus, &view) && view == NULL);
+    closeCorpus(corpus);
+
+    f = fopen(fileName, "w");
+    fprintf(f, "{\"pastPlays\": \"GGE.... SGE....\"}\n"
+               "{\"pastPlays\": \"GGE.... SGE....\n"
+               "{\"pastPlays\": \"GGE.... SGE.... HGE....\"}\n"
+               "{\"pastPlays\": \"GGE.... SGE.... HGE....\"}\n"
+               "{\"pastPlays\": \"GGE.... SGEX...\"}\n"
+               "{\"pastPlays\": \"GMA....\"");
+    fclose(f);
+
+    int lengths[] = {15, 23, 23, 15, 7};
+    int shared[] = {0, 15, 23, 0, 0};
+    corpus = openCorpus(fileName);
+    int i;
+    for(i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        assert(nextPosition(corpus, &position));
+        assert(position.length == lengths[i] && position.shared == shared[i]);
+    }
+    assert(!nextPosition(corpus, &position));
+    closeCorpus(corpus);
+
+    remove(fileName);
+}
+
+static void assertSameGameView(GameView a, GameView b) {
+    assert(getRound(a) == getRound(b));
+    assert(getCurrentPlayer(a) == getCurrentPlayer(b));
+    assert(getScore(a) == getScore(b));
+
+    int plays = getRound(a) * NUM_PLAYERS + getCurrentPlayer(a);
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        assert(getHealthAfter(a, p, plays) == getHealthAfter(b, p, plays));
+        assert(getLocation(a, p) == getLocation(b, p));
+
+        int numA, numB;
+        const LocationID *movesA = getMoves(a, p, &numA);
+        const LocationID *movesB = getMoves(b, p, &numB);
+        assert(numA == numB);
+        assert(memcmp(movesA, movesB, numA * sizeof(LocationID)) == 0);
+    }
+
+    int numA, numB;
+    const Event *eventsA = getEvents(a, &numA);
+    const Event *eventsB = getEvents(b, &numB);
+    assert(numA == numB);
+    assert(numA == 0 || memcmp(eventsA, eventsB, numA * sizeof(Event)) == 0);
+}
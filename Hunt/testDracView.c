@@ -0,0 +1,288 @@
+// testDracView.c ... test the DracView ADT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "DracView.h"
+#include "GameView.h"
+
+static void testThreatIndex(void);
+static void testUpdateDracView(void);
+static void testCloneDracView(void);
+static void testGiveMeTheState(void);
+static void assertSameDracView(DracView a, DracView b);
+static char *firstPlays(char *plays, int numPlays);
+
+// A logged game with every kind of encounter and special move, including a teleport
+static char *wholeGame =
+    "GGE.... SPA.... HMI.... MCF.... DCG.V.. GMI.... SBO.... HMU.... MMR.... "
+    "DHIT... GZU.... SCO.... HMI.... MMI.... DD1T... GLI.... SFR.... HFL.... "
+    "MZU.... DMS.... GBR.... SCO.... HGE.... MLI.... DALT... GPR.... SAM.... "
+    "HZU.... MBR.... DSRT... GBR.... SNS.... HGE.... MPR.... DMAT.V. GMU.... "
+    "SAM.... HMI.... MBR.... DCAT.M. GMI.... SNS.... HZU.... MMU.... DLST.M. "
+    "GFL.... SAM.... HLI.... MMI.... DHIT... GGE.... SNS.... HBR.... MFL.... "
+    "DD1T.M. GZU.... SAM.... HPR.... MGE.... DSNT.M. GGE.... SNS.... HBR.... "
+    "MZU.... DSRT.M. GMI.... SAM.... HMU.... MGE.... DBO.VM. GZU.... SNS.... "
+    "HMI.... MMI.... DTOT.M. GLI.... SAM.... HFL.... MZU.... DHIT.M. GBR.... "
+    "SNS.... HGE.... MLI.... DBAT.M. GPR.... SHA.... HGO.... MNU.... DD1T.M. "
+    "GVE.... SCO.... HVE.... MST.... DSRT.M. GVI.... SST.... HVI.... MZU.... "
+    "DBOT.V. GMU.... SCO.... HVE.... MGO.... DCFT.M. GZA.... SPA.... HVI.... "
+    "MVE.... DTOT.M. GVI.... SCFT... HMU.... MVI.... DBAT.M. GHA.... STOT... "
+    "HZA.... MVE.... DMS..M. GCO.... SSRT... HVI.... MVI.... DD1.... GST.... "
+    "SBAT... HHA.... MMU.... DTS..M. GZU.... SBA.... HCO.... MZA.... DRO.V.. "
+    "GGO.... STO.... HST.... MVI.... DNPT... GVE.... SSR.... HZU.... MHA.... "
+    "DHIT... GVI.... SBA.... HGO.... MCO.... DBIT... GVE.... SLS.... HVE.... "
+    "MST.... DD1T... GVI.... SCA.... HVI.... MZU.... DAS.... GMU.... SGR.... "
+    "HVE.... MGO.... DIO..V. GZA.... SMA.... HVI.... MVE.... DVAT.M. GSJ.... "
+    "SBO.... HPR.... MGO.... DATT.M. GZA.... STO.... HVI.... MVE.... DHIT.M. "
+    "GSJ.... SSR.... HVE.... MGO.... DD1T.M. GZA.... SSN.... HGO.... MVE.... "
+    "DTPT... GSJ.... SMA.... HVE.... MGO.... DKLT... GZA.... SGR.... HGO.... "
+    "MVE.... DGA.VM. GSJ.... SMA.... HVE.... MGO.... DBCT.M. GZA.... SSN.... "
+    "HGO.... MVE.... DCNT.M. GSJ.... SMA.... HVE.... MGO.... DHIT.M. GZA.... "
+    "SGR.... HGO.... MVE.... DD1T.M. GSJ.... SMA.... HVE.... MGO.... DVRT.M. "
+    "GZA.... SSN.... HGO.... MVE.... DSOT.V. GSJ.... SMA.... HVE.... MGO.... "
+    "DBCT.M. GZA.... SGR.... HGO.... MVE.... DKLT.M. GSJ.... SMA.... HVE.... "
+    "MGO.... DHIT.M. GZA.... SSN.... HGO.... MVE.... DGAT.M. GSJ.... SMA.... "
+    "HVE.... MGO.... DD1T.M. GZA.... SGR.... HGO.... MVE.... DCNT.M. GSZ.... "
+    "SCA.... HGE.... MBD.... DVR.VM. GJM.... SLS.... HFL.... MVI.... DSOT.M. "
+    "GSZ.... SBA.... HRO.... MPR.... DSJT.M. GSOT... SSR.... HNP.... MBD.... "
+    "DVAT.M. GVATD.. SSN.... HRO.... MVI.... DIO..M. GVA.... SLS.... HGE.... "
+    "MPR.... DD1..M. GSA.... SBA.... HPA.... MNU.... DBS..V. GVA.... SSR.... "
+    "HCF.... MPR.... DCNT... GSA.... SSN.... HPA.... MBD.... DVRT.M. GSO.... "
+    "SLS.... HFR.... MVI.... DHIT... GBC.... SBA.... HNU.... MPR.... DSOT... "
+    "GCNT... SSR.... HMU.... MBD.... DD1T... GCN.... SSN.... HNU.... MVI.... "
+    "DSJT... GGA.... SLS.... HFR.... MPR.... DVA.V.. GCN.... SBA.... HNU.... "
+    "MNU.... DSAT.M. GBS.... SSR.... HMU.... MLI.... DHIT.M. GVR.... SBO.... "
+    "HVE.... MMU.... DIO..M. GSOT... SMA.... HSZ.... MZA.... DD1.... GVAV... "
+    "SSR.... HJM.... MSJT...";
+
+int main(int argc, char *argv[]) {
+    testThreatIndex();
+    testUpdateDracView();
+    testCloneDracView();
+    testGiveMeTheState();
+
+    return EXIT_SUCCESS;
+}
+
+// Compare the reverse reachability index against forward searches
+static void testThreatIndex(void) {
+    printf("Test for the reverse reachability index\n");
+    PlayerMessage messages[] = {"", "", "", "", "", "", "", "", ""};
+    char *plays = "GMA.... SCD.... HJM.... MLO.... DGA.... "
+                  "GSN.... SKL.... HBE.... MEC....";
+    DracView dv = newDracView(plays, messages);
+    GameView gv = newGameView(plays, messages);
+
+    LocationID from, to, v;
+    int phase, k;
+    for(from = MIN_MAP_LOCATION; from <= MAX_MAP_LOCATION; from++) {
+        for(phase = 0; phase < NUM_RAIL_PHASES; phase++) {
+
+            // where a hunter at 'from' can be after k rounds
+            int seen[NUM_MAP_LOCATIONS];
+            for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) seen[v] = (v == from);
+
+            for(k = 0; k <= MAX_THREAT_ROUNDS; k++) {
+                for(to = MIN_MAP_LOCATION; to <= MAX_MAP_LOCATION; to++) {
+                    LocationSet threats = threatSet(dv, to, k, phase);
+                    assert(inSet(threats, from) == seen[to]);
+                }
+
+                int next[NUM_MAP_LOCATIONS];
+                for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) next[v] = seen[v];
+                for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+                    if(!seen[v]) continue;
+
+                    int reachable[NUM_MAP_LOCATIONS];
+                    reachableFrom(gv, reachable, v, PLAYER_LORD_GODALMING, phase + k, 1, 1, 1);
+                    for(to = MIN_MAP_LOCATION; to <= MAX_MAP_LOCATION; to++) {
+                        if(reachable[to]) next[to] = TRUE;
+                    }
+                }
+                for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) seen[v] = next[v];
+            }
+        }
+    }
+
+    // After 9 plays the hunters next move in round 2, each with his own
+    // phase: Lord Godalming at Santander can take the train two stops
+    // (phase 2 + 0), as far as Alicante but not on to Barcelona, and
+    // Dr Seward (phase 2 + 1) is at Klausenburg, which has no railway
+    assert(huntersThreatening(dv, SANTANDER, 0) == 1 << PLAYER_LORD_GODALMING);
+    assert(huntersThreatening(dv, MADRID, 1) & (1 << PLAYER_LORD_GODALMING));
+    assert(huntersThreatening(dv, ALICANTE, 1) == 1 << PLAYER_LORD_GODALMING);
+    assert(!(huntersThreatening(dv, BARCELONA, 1) & (1 << PLAYER_LORD_GODALMING)));
+    assert(huntersThreatening(dv, CASTLE_DRACULA, 1) == 1 << PLAYER_DR_SEWARD);
+    assert(huntersThreatening(dv, GALWAY, 1) == 0);
+    printf("passed\n");
+
+    disposeGameView(gv);
+    disposeDracView(dv);
+}
+
+// Views brought up to date a few plays at a time should match a full reparse
+static void testUpdateDracView(void) {
+    printf("Test for updating a DracView with new plays\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000], later[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int start, step;
+    for(start = 0; start < total; start += 47) {
+        for(step = 1; step <= 5; step += 2) {
+            DracView dv = newDracView(firstPlays(plays, start), messages);
+
+            int done = start;
+            while(done < total) {
+                int next = done + step > total ? total : done + step;
+                int length = strlen(firstPlays(plays, done));
+
+                updateDracView(dv, firstPlays(later, next) + length);
+                done = next;
+
+                DracView whole = newDracView(firstPlays(plays, done), messages);
+                assertSameDracView(dv, whole);
+                disposeDracView(whole);
+            }
+
+            disposeDracView(dv);
+        }
+    }
+
+    printf("passed\n");
+}
+
+static void testCloneDracView(void) {
+    printf("Test for cloning and snapshots of a DracView\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000], later[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int start;
+    for(start = 0; start < total; start += 29) {
+        int next = start + 10 > total ? total : start + 10;
+        int length = strlen(firstPlays(plays, start));
+        DracView now = newDracView(plays, messages);
+        DracView ahead = newDracView(firstPlays(later, next), messages);
+
+        DracView original = newDracView(plays, messages);
+        DracView clone = cloneDracView(original);
+        updateDracView(clone, later + length);
+        assertSameDracView(clone, ahead);
+        assertSameDracView(original, now);
+
+        // the clone keeps the shared threat index after the original goes
+        disposeDracView(original);
+        assertSameDracView(clone, ahead);
+        PlayerID p;
+        for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+            LocationID trail[TRAIL_SIZE];
+            int numMoves, i;
+            const LocationID *whole = giveMeTheWholeTrail(clone, p, &numMoves);
+            giveMeTheTrail(ahead, p, trail);
+            for(i = 0; i < TRAIL_SIZE && i < numMoves; i++) assert(trail[i] == whole[numMoves - 1 - i]);
+        }
+        LocationID where;
+        for(where = MIN_MAP_LOCATION; where <= MAX_MAP_LOCATION; where++) {
+            assert(huntersThreatening(clone, where, MAX_THREAT_ROUNDS) ==
+                   huntersThreatening(ahead, where, MAX_THREAT_ROUNDS));
+        }
+
+        // and a snapshot of it comes back the same
+        static Snapshot snapshot;
+        takeDracSnapshot(clone, &snapshot);
+        DracView restored = restoreDracView(&snapshot);
+        assertSameDracView(restored, ahead);
+        disposeDracView(restored);
+
+        disposeDracView(clone);
+        disposeDracView(now);
+        disposeDracView(ahead);
+    }
+
+    printf("passed\n");
+}
+
+// The state in one call against the accessors, at each of Dracula's turns
+static void testGiveMeTheState(void) {
+    printf("Test for giveMeTheState\n");
+    char plays[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int n, i;
+    for(n = NUM_PLAYERS - 1; n <= total; n += NUM_PLAYERS) {
+        DracView dv = newDracView(firstPlays(plays, n), NULL);
+
+        ViewState state;
+        giveMeTheState(dv, &state);
+        assert(state.round == giveMeTheRound(dv));
+        assert(state.currentPlayer == PLAYER_DRACULA);
+        assert(state.score == giveMeTheScore(dv));
+
+        PlayerID p;
+        for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+            assert(state.health[p] == howHealthyIs(dv, p));
+            assert(state.location[p] == whereIs(dv, p));
+
+            LocationID trail[TRAIL_SIZE], moves[TRAIL_SIZE];
+            giveMeTheTrail(dv, p, trail);
+            giveMeTheMoves(dv, p, moves);
+            for(i = 0; i < TRAIL_SIZE; i++) {
+                assert(state.trail[p][i] == trail[i]);
+                assert(state.moves[p][i] == moves[i]);
+            }
+        }
+
+        // a copy: it stays as it was when the view moves on
+        ViewState before = state;
+        updateDracView(dv, wholeGame + strlen(plays));
+        assert(memcmp(&before, &state, sizeof(ViewState)) == 0);
+        disposeDracView(dv);
+    }
+
+    printf("passed\n");
+}
+
+static void assertSameDracView(DracView a, DracView b) {
+    assert(giveMeTheRound(a) == giveMeTheRound(b));
+    assert(giveMeTheScore(a) == giveMeTheScore(b));
+
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        assert(howHealthyIs(a, p) == howHealthyIs(b, p));
+        assert(whereIs(a, p) == whereIs(b, p));
+
+        LocationID startA, endA, startB, endB;
+        lastMove(a, p, &startA, &endA);
+        lastMove(b, p, &startB, &endB);
+        assert(startA == startB && endA == endB);
+
+        LocationID trailA[TRAIL_SIZE], trailB[TRAIL_SIZE];
+        giveMeTheTrail(a, p, trailA);
+        giveMeTheTrail(b, p, trailB);
+        assert(memcmp(trailA, trailB, sizeof(trailA)) == 0);
+        giveMeTheMoves(a, p, trailA);
+        giveMeTheMoves(b, p, trailB);
+        assert(memcmp(trailA, trailB, sizeof(trailA)) == 0);
+    }
+
+    LocationID where;
+    for(where = MIN_MAP_LOCATION; where <= MAX_MAP_LOCATION; where++) {
+        int trapsA, vampsA, trapsB, vampsB;
+        whatsThere(a, where, &trapsA, &vampsA);
+        whatsThere(b, where, &trapsB, &vampsB);
+        assert(trapsA == trapsB && vampsA == vampsB);
+    }
+}
+
+// Copies the first numPlays plays of wholeGame into plays
+static char *firstPlays(char *plays, int numPlays) {
+    int length = numPlays == 0 ? 0 : numPlays * PLAY_LENGTH - 1;
+    assert(length <= strlen(wholeGame));
+
+    strncpy(plays, wholeGame, length);
+    plays[length] = '\0';
+    return plays;
+}
@@ -0,0 +1,81 @@
+// testGameBatch.c ... test parsing many games at once
+//
+// Parses every position in the given logs (or every log in GameLog/) with
+// parseBatch() using various numbers of threads, checking each state
+// against parsing the same position alone.
+// Usage: ./testGameBatch [log...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "Globals.h"
+#include "GameBatch.h"
+#include "LogReader.h"
+
+#define MAX_POSITIONS 20000
+
+static char *positions[MAX_POSITIONS];
+static int numPositions;
+
+static void keepPositions(char *fileName);
+static void keepPosition(char *pastPlays, int length, void *arg);
+static void assertSameState(const GameState *a, const GameState *b);
+
+int main(int argc, char *argv[]) {
+    printf("Test for parsing a batch of games\n");
+
+    int i;
+    forEachLog(argc - 1, argv + 1, keepPositions);
+    assert(numPositions > BATCH_CHUNK);
+
+    static GameState expected[MAX_POSITIONS], states[MAX_POSITIONS];
+    for(i = 0; i < numPositions; i++) {
+        initGameState(&expected[i]);
+        applyPlaysToState(&expected[i], positions[i]);
+    }
+
+    // more threads than chunks, a few, one per processor, and part of a chunk
+    int threads[] = {1, 3, 0, 1000};
+    int t;
+    for(t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        memset(states, 0xff, sizeof(states));
+        parseBatch(positions, numPositions, states, threads[t]);
+        for(i = 0; i < numPositions; i++) assertSameState(&states[i], &expected[i]);
+        assertSameState(&states[numPositions], &states[MAX_POSITIONS - 1]);   // untouched
+    }
+
+    memset(states, 0xff, sizeof(states));
+    parseBatch(positions + 1, BATCH_CHUNK / 2, states, 4);
+    for(i = 0; i < BATCH_CHUNK / 2; i++) assertSameState(&states[i], &expected[i + 1]);
+    parseBatch(positions, 0, states, 0);
+
+    for(i = 0; i < numPositions; i++) free(positions[i]);
+    printf("passed (%d positions)\n", numPositions);
+    return EXIT_SUCCESS;
+}
+
+// Keeps every pastPlays string in a log
+static void keepPositions(char *fileName) {
+    readLog(fileName, keepPosition, NULL);
+}
+
+static void keepPosition(char *pastPlays, int length, void *arg) {
+    if(numPositions == MAX_POSITIONS) return;
+
+    positions[numPositions] = malloc(length + 1);
+    assert(positions[numPositions] != NULL);
+    strcpy(positions[numPositions++], pastPlays);
+}
+
+static void assertSameState(const GameState *a, const GameState *b) {
+    assert(a->trailMoves == b->trailMoves);
+    assert(a->trailLocations == b->trailLocations);
+    assert(a->turn == b->turn);
+    assert(a->score == b->score);
+    assert(memcmp(a->health, b->health, sizeof(a->health)) == 0);
+    assert(memcmp(a->location, b->location, sizeof(a->location)) == 0);
+    assert(a->killed == b->killed);
+    assert(a->traps == b->traps);
+    assert(a->vamps == b->vamps);
+}
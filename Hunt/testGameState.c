@@ -0,0 +1,158 @@
+// testGameState.c ... test making and unmaking moves on a GameState
+//
+// Replays every game in the given logs (or every log in GameLog/),
+// looking a few plays ahead from each play with makeMove() and taking
+// them back with unmakeMove(), and making its plays again as scanPlays()
+// decodes them. Then checks scanPlays() turns down plays that aren't.
+// Usage: ./testGameState [log...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "Globals.h"
+#include "GameState.h"
+#include "LogReader.h"
+
+#define LOOK_AHEAD 7                 // plays made and unmade from each play
+
+static int numGames;
+
+static void replayLog(char *fileName);
+static void replayIfNewGame(char *pastPlays, int length, void *arg);
+static void replayGame(char *pastPlays);
+static void scanGame(char *pastPlays);
+static void testBadPlays(void);
+static void assertSameState(const GameState *a, const GameState *b);
+
+int main(int argc, char *argv[]) {
+    printf("Test for making and unmaking moves\n");
+
+    forEachLog(argc - 1, argv + 1, replayLog);
+
+    assert(numGames > 0);
+    testBadPlays();
+    printf("passed (%d games)\n", numGames);
+    return EXIT_SUCCESS;
+}
+
+// Replays each game in a log once: a log has the pastPlays of every turn,
+// so only the longest of each run of pastPlays extending the one before
+static void replayLog(char *fileName) {
+    static char game[MAX_PLAYS * PLAY_LENGTH];
+    game[0] = '\0';
+
+    readLog(fileName, replayIfNewGame, game);
+    replayGame(game);
+}
+
+// Replays the game so far once pastPlays doesn't carry it on
+static void replayIfNewGame(char *pastPlays, int length, void *arg) {
+    char *game = arg;
+    if(strncmp(pastPlays, game, strlen(game)) != 0) replayGame(game);
+    strcpy(game, pastPlays);
+}
+
+// Makes and unmakes up to LOOK_AHEAD plays from every play of the game,
+// checking each play made matches applyPlayToState() and each play taken
+// back gives the state before it again
+static void replayGame(char *pastPlays) {
+    int total = (strlen(pastPlays) + 1) / PLAY_LENGTH;
+    if(total == 0) return;
+    numGames++;
+
+    GameState state;
+    initGameState(&state);
+
+    int i, d;
+    for(i = 0; i < total; i++) {
+        GameState before[LOOK_AHEAD + 1];
+        Undo undo[LOOK_AHEAD];
+        int depth = total - i < LOOK_AHEAD ? total - i : LOOK_AHEAD;
+
+        GameState search = state;
+        before[0] = state;
+        for(d = 0; d < depth; d++) {
+            char *play = pastPlays + (i + d) * PLAY_LENGTH;
+
+            GameState expected = search;
+            applyPlayToState(&expected, play);
+            makeMove(&search, &undo[d], play);
+            assertSameState(&search, &expected);
+            before[d + 1] = search;
+        }
+
+        for(d = depth - 1; d >= 0; d--) {
+            assertSameState(&search, &before[d + 1]);
+            unmakeMove(&search, &undo[d]);
+        }
+        assertSameState(&search, &state);
+
+        applyPlayToState(&state, pastPlays + i * PLAY_LENGTH);
+    }
+
+    scanGame(pastPlays);
+}
+
+// Makes a game's plays as scanPlays() decodes them, in pieces as a GameView
+// would get them, checking the state after each matches applyPlayToState()
+static void scanGame(char *pastPlays) {
+    static DecodedPlay decoded[MAX_PLAYS];
+    int length = strlen(pastPlays);
+    int total = (length + 1) / PLAY_LENGTH;
+    assert(scanPlays(pastPlays, length, decoded) == total);
+
+    GameState state, expected;
+    initGameState(&state);
+    initGameState(&expected);
+
+    //pieces of 1, 2, 3, ... plays, each but the first starting with a space
+    int start = 0, size = 1, i;
+    while(start < total) {
+        int end = start + size < total ? start + size : total;
+        char *from = pastPlays + start * PLAY_LENGTH - (start > 0);
+        int chars = (end - start) * PLAY_LENGTH - (end == total) + (start > 0);
+        assert(scanPlays(from, chars, decoded) == end - start);
+
+        for(i = start; i < end; i++) {
+            assert(applyDecodedToState(&state, &decoded[i - start]) == applyPlayToState(&expected, pastPlays + i * PLAY_LENGTH));
+            assertSameState(&state, &expected);
+        }
+        start = end;
+        size++;
+    }
+}
+
+static void testBadPlays(void) {
+    DecodedPlay decoded[4];
+
+    assert(scanPlays("", 0, decoded) == 0);
+    assert(scanPlays("GMN.... SPL....", 15, decoded) == 2);
+    assert(decoded[1].player == PLAYER_DR_SEWARD && decoded[1].move == PLYMOUTH);
+    assert(scanPlays("GMN.... SPL.... ", 16, decoded) == 2);
+    assert(scanPlays("DC?T.V.", 7, decoded) == 1);
+    assert(decoded[0].player == PLAYER_DRACULA && decoded[0].move == CITY_UNKNOWN);
+    assert(decoded[0].actions == (ACTION_TRAP | ACTION_VAMPIRE << (2 * ACTION_BITS)));
+    assert(scanPlays("HSZTD..", 7, decoded) == 1);
+    assert(decoded[0].actions == (ACTION_TRAP | ACTION_OTHER << ACTION_BITS));
+
+    assert(scanPlays("XMN....", 7, decoded) == -1);         // no such player
+    assert(scanPlays("GXX....", 7, decoded) == -1);         // no such move
+    assert(scanPlays("GMN..x.", 7, decoded) == -1);         // no such action
+    assert(scanPlays("GMN..M.", 7, decoded) == -1);         // only Dracula's traps malfunction
+    assert(scanPlays("DCD.D..", 7, decoded) == -1);         // Dracula doesn't meet himself
+    assert(scanPlays("GMN....xSPL....", 15, decoded) == -1);  // no space between plays
+    assert(scanPlays("GMN.... SPL...", 14, decoded) == -1);   // part of a play
+}
+
+static void assertSameState(const GameState *a, const GameState *b) {
+    assert(a->trailMoves == b->trailMoves);
+    assert(a->trailLocations == b->trailLocations);
+    assert(a->turn == b->turn);
+    assert(a->score == b->score);
+    assert(memcmp(a->health, b->health, sizeof(a->health)) == 0);
+    assert(memcmp(a->location, b->location, sizeof(a->location)) == 0);
+    assert(a->killed == b->killed);
+    assert(a->traps == b->traps);
+    assert(a->vamps == b->vamps);
+}
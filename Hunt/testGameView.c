@@ -0,0 +1,763 @@
+// testGameView.c ... test the GameView ADT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "GameView.h"
+
+static void testPathCounts(void);
+static void testMoveDecoding(void);
+static void testApplyPlays(void);
+static void testDraculaLocations(void);
+static void testGameState(void);
+static void testCloneGameView(void);
+static void testSnapshots(void);
+static void testWholeHistory(void);
+static void testEvents(void);
+static void testTimeline(void);
+static void testMessages(void);
+static void assertSameGameView(GameView a, GameView b);
+static int corruptSnapshot(Snapshot *snapshot, int how);
+static char *firstPlays(char *plays, int numPlays);
+
+// A logged game with traps, vampires, double backs, a hide and a hunter sent to hospital
+static char *wholeGame =
+    "GGE.... SPA.... HMI.... MCF.... DMA.V.. GPA.... SBU.... HST.... MNA.... "
+    "DLST... GBU.... SBO.... HZU.... MLE.... DCAT... GFR.... SSR.... HMU.... "
+    "MMR.... DGRT... GST.... SMAV... HZU.... MCO.... DALT... GZU.... SSR.... "
+    "HMI.... MHA.... DMS.... GST.... SMR.... HVE.... MNS.... DCGT... GFL.... "
+    "SGO.... HMI.... MEC.... DHIT.M. GGO.... STS.... HST.... MNS.... DD1T.M. "
+    "GTS.... SMS.... HFL.... MEC.... DTS..M. GMS.... SCGTTT. HGO.... MNS.... "
+    "DROT.M. GCG.... STS.... HTS.... MEC.... DBIT... GTS.... SMS.... HMS.... "
+    "MNS.... DNPT... GMS.... SCG.... HCG.... MEC.... DHI.V.. GCG.... STS.... "
+    "HTS.... MNS.... DD1T... GTS.... SMS.... HMS.... MEC.... DTS.... GMS.... "
+    "SCG.... HCG.... MNS.... DROT.M. GCG.... STS.... HTS.... MEC.... DBIT.M. "
+    "GTS.... SMS.... HMS.... MNS.... DNPT.M. GMS.... SCG.... HCG.... MEC.... "
+    "DHIT.V. GCG.... STS.... HTS.... MNS.... DD1T.M. GTS.... SMS.... HMS.... "
+    "MEC.... DTS.... GMS.... SCG.... HCG.... MNS.... DROT.M. GCG.... STS.... "
+    "HTS.... MEC.... DBIT.M. GTS.... SMS.... HMS.... MNS.... DNPT.M. GMS.... "
+    "SCG.... HCG.... MEC.... DHIT.M. GCG.... STS.... HTS.... MNS.... DD1.VM. "
+    "GTS.... SMS.... HCG.... MED.... DTS.... GCG.... SAL.... HMS.... MMN.... "
+    "DGOT.M. GMS.... SMA.... HAL.... MED.... DMRT.M. GAL.... SCA.... HGR.... "
+    "MMN.... DCFT.M. GBA.... SAO.... HAL.... MED.... DGET.M. GMS.... SBB.... "
+    "HMA.... MMN.... DSTT.V. GAL.... SAO.... HCA.... MED.... DBUT... GMA.... "
+    "SBB.... HAO.... MMN.... DAMT.M. GCA.... SAO.... HBB.... MED.... DCOT.M. "
+    "GAO.... SBB.... HAO.... MMN.... DFRT.M. GBB.... SAO.... HBB.... MED.... "
+    "DLIT.M. GAO.... SBB.... HAO.... MMN.... DBRT.M. GBB.... SAO.... HBB.... "
+    "MED.... DHA.VM. GAO.... SBB.... HAO.... MMN.... DHIT.M. GBB.... SAO.... "
+    "HBB.... MED.... DCOT.M. GAO.... SBB.... HAO.... MMN.... DAMT.M. GBB.... "
+    "SAO.... HBB.... MED.... DBUT.M. GAO.... SBB.... HAO.... MMN.... DLET.M. "
+    "GBB.... SAO.... HBB.... MED.... DNAT.V. GAO.... SMS.... HNATD.. MMN.... "
+    "DBB..M. GMS.... SMR.... HLET... MLO.... DSNT.M. GMR.... STO.... HLE.... "
+    "MPL.... DMAT.M. GTO.... SMR.... HPA.... MEC.... DLST.M. GMR.... SGO.... "
+    "HNA.... MNS.... DCAT... GGO.... STS.... HLE.... MEC.... DGRT... GTS.... "
+    "SNP.... HNA.... MNS.... DAL.V.. GNP.... SRO.... HLE.... MEC.... DSRT.M. "
+    "GRO.... STS.... HNA.... MNS.... DSNT.M. GTS.... SNP.... HLE.... MEC.... "
+    "DMAT.M. GNP.... SRO.... HNA.... MNS.... DLST.M. GRO.... SNP.... HLE.... "
+    "MEC.... DCAT.M. GNP.... SRO.... HNA.... MNS.... DGRT.V. GRO.... SNP.... "
+    "HLE.... MEC.... DALT.M. GNP.... SRO.... HNA.... MNS.... DSRT.M. GRO.... "
+    "SNP.... HLE.... MEC.... DSNT.M. GNP.... SRO.... HNA.... MNS.... DLST.M. "
+    "GBI.... SNP.... HBB.... MAM.... DCAT.M. GAS.... SBI.... HNA.... MBU.... "
+    "DGRT.M. GBI.... SAS.... HBB.... MAM.... DAL.VM. GAS.... SBI.... HNA.... "
+    "MBU.... DMAT.M. GBI.... SAS.... HBB.... MPA.... DSNT.M. GAS.... SBI.... "
+    "HNA.... MMAT... DBB..M. GBI.... SAS.... HBB.... MALV... DAO..M. GAS.... "
+    "SBI.... HNA.... MBA.... DCAT.M. GBI.... SAS.... HBB.... MAL.... DHIT... "
+    "GAS.... SBI.... HNA.... MSNT... DGRT... GBI.... SAS.... HBB.... MMA.... "
+    "DALT... GAS.... SBI.... HNA.... MALTD.. DMAT... GBI.... SAS.... HBB.... "
+    "MSZ.... DSNT... GAS.... SBI.... HNA.... MVI.... DLST.M. GBI.... SAS.... "
+    "HCF.... MZA.... DCAT.M. GAS.... SBI.... HNA.... MJM.... DGR.VM. GBI.... "
+    "SAS.... HCF.... MZA.... DALT... GAS.... SBI.... HNA.... MJM....";
+static int countRoutes(GameView gv, LocationID from, LocationID to, PlayerID player,
+                       Round round, int movesLeft);
+
+int main(int argc, char *argv[]) {
+    testPathCounts();
+    testMoveDecoding();
+    testApplyPlays();
+    testDraculaLocations();
+    testGameState();
+    testCloneGameView();
+    testSnapshots();
+    testWholeHistory();
+    testEvents();
+    testTimeline();
+    testMessages();
+
+    return EXIT_SUCCESS;
+}
+
+// Compare pathCounts() against brute-force enumeration of every route
+static void testPathCounts(void) {
+    printf("Test for shortest path counts\n");
+    PlayerMessage messages[] = {""};
+    GameView gv = newGameView("", messages);
+
+    int dist[NUM_MAP_LOCATIONS], numPaths[NUM_MAP_LOCATIONS], through[NUM_MAP_LOCATIONS];
+
+    // Madrid -> Paris by road only: via Santander or Saragossa, then Bordeaux
+    pathCounts(gv, MADRID, PARIS, PLAYER_LORD_GODALMING, 0, 1, 0, 0, dist, numPaths, through);
+    assert(dist[MADRID] == 0 && numPaths[MADRID] == 1);
+    assert(dist[PARIS] == 4);
+    assert(through[MADRID] == numPaths[PARIS]);
+    assert(through[PARIS] == numPaths[PARIS]);
+    assert(through[ST_JOSEPH_AND_ST_MARYS] == 0);
+
+    // Dracula can never get to the hospital
+    pathCounts(gv, BELGRADE, KLAUSENBURG, PLAYER_DRACULA, 0, 1, 0, 1, dist, numPaths, NULL);
+    assert(dist[ST_JOSEPH_AND_ST_MARYS] == NO_PATH);
+    assert(numPaths[ST_JOSEPH_AND_ST_MARYS] == 0);
+
+    PlayerID player;
+    LocationID from, to;
+    for(player = PLAYER_LORD_GODALMING; player <= PLAYER_DRACULA; player += 2) {
+        for(from = MIN_MAP_LOCATION; from <= MAX_MAP_LOCATION; from += 7) {
+            if(player == PLAYER_DRACULA && from == ST_JOSEPH_AND_ST_MARYS) continue;
+
+            pathCounts(gv, from, NOWHERE, player, 1, 1, 1, 1, dist, numPaths, NULL);
+            for(to = MIN_MAP_LOCATION; to <= MAX_MAP_LOCATION; to++) {
+                if(dist[to] == NO_PATH || dist[to] > 3) continue;
+                assert(numPaths[to] == countRoutes(gv, from, to, player, 1, dist[to]));
+                assert(dist[to] == 0 || countRoutes(gv, from, to, player, 1, dist[to] - 1) == 0);
+            }
+        }
+    }
+
+    // with rail a route can come back to a place in a later phase, but it still
+    // only goes through it once
+    Round round;
+    for(player = PLAYER_LORD_GODALMING; player < PLAYER_DRACULA; player++) {
+        for(round = 0; round < NUM_RAIL_PHASES; round++) {
+            for(from = MIN_MAP_LOCATION + player; from <= MAX_MAP_LOCATION; from += 7) {
+                for(to = MIN_MAP_LOCATION; to <= MAX_MAP_LOCATION; to++) {
+                    pathCounts(gv, from, to, player, round, 1, 1, 1, dist, numPaths, through);
+                    if(dist[to] == NO_PATH) continue;
+                    assert(through[from] == numPaths[to] && through[to] == numPaths[to]);
+
+                    LocationID v;
+                    for(v = MIN_MAP_LOCATION; v <= MAX_MAP_LOCATION; v++) {
+                        assert(through[v] <= numPaths[to]);
+                    }
+                }
+            }
+        }
+    }
+    pathCounts(gv, 5, 19, PLAYER_LORD_GODALMING, 0, 1, 1, 1, dist, numPaths, through);
+    assert(numPaths[19] == 29 && through[5] == 29);
+
+    printf("passed\n");
+    disposeGameView(gv);
+}
+
+// Number of routes from 'from' to 'to' made of exactly movesLeft real moves
+static int countRoutes(GameView gv, LocationID from, LocationID to, PlayerID player,
+                       Round round, int movesLeft) {
+    if(movesLeft == 0) return (from == to);
+
+    int n = 0, total = 0;
+    LocationID *next = connectedLocations(gv, &n, from, player, round, 1, 1, 1);
+
+    int i;
+    for(i = 0; i < n; i++) {
+        if(next[i] == from) continue;   // resting is not a move
+        total += countRoutes(gv, next[i], to, player, round + 1, movesLeft - 1);
+    }
+
+    free(next);
+    return total;
+}
+
+// Every move should decode back to itself, and nothing else should decode
+static void testMoveDecoding(void) {
+    printf("Test for two char move decoding\n");
+
+    LocationID id;
+    for(id = MIN_MAP_LOCATION; id <= MAX_MAP_LOCATION; id++) {
+        char *abbrev = idToAbbrev(id);
+        assert(strlen(abbrev) == 2);
+        assert(moveToID(abbrev) == id);
+        assert(abbrevToID(abbrev) == id);
+    }
+    for(id = CITY_UNKNOWN; id <= TELEPORT; id++) {
+        char *abbrev = idToAbbrev(id);
+        assert(moveToID(abbrev) == id);
+        assert(abbrevToID(abbrev) == NOWHERE);
+    }
+
+    assert(moveToID("CD") == CASTLE_DRACULA);
+    assert(moveToID("D3") == DOUBLE_BACK_3);
+    assert(moveToID("C?") == CITY_UNKNOWN);
+    assert(moveToID("D6") == NOWHERE);
+    assert(moveToID("H?") == NOWHERE);
+    assert(moveToID("cd") == NOWHERE);
+    assert(moveToID("Z]") == NOWHERE);
+    assert(moveToID("..") == NOWHERE);
+    assert(strcmp(idToAbbrev(ST_JOSEPH_AND_ST_MARYS), "JM") == 0);
+    assert(strcmp(idToAbbrev(TELEPORT), "TP") == 0);
+
+    printf("passed\n");
+}
+
+// Views brought up to date a few plays at a time should match a full reparse
+static void testApplyPlays(void) {
+    printf("Test for applying new plays\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000], later[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int start, step;
+    for(start = 0; start < total; start += 7) {
+        for(step = 1; step <= 4; step++) {
+            GameView gv = newGameView(firstPlays(plays, start), messages);
+
+            int done = start;
+            while(done < total) {
+                int next = done + step > total ? total : done + step;
+                int length = strlen(firstPlays(plays, done));
+
+                // the new plays start with the space after the last one applied
+                applyPlays(gv, firstPlays(later, next) + length);
+                done = next;
+
+                GameView whole = newGameView(firstPlays(plays, done), messages);
+                assertSameGameView(gv, whole);
+                disposeGameView(whole);
+            }
+
+            disposeGameView(gv);
+        }
+    }
+
+    // nothing new to apply
+    GameView gv = newGameView(firstPlays(plays, total), messages);
+    applyPlays(gv, "");
+    GameView whole = newGameView(plays, messages);
+    assertSameGameView(gv, whole);
+    disposeGameView(gv);
+    disposeGameView(whole);
+
+    printf("passed\n");
+}
+
+// Dracula's special moves resolve to where they took him, as far as is known
+static void testDraculaLocations(void) {
+    printf("Test for Dracula's locations and minions\n");
+    PlayerMessage messages[] = {""};
+    LocationID trail[TRAIL_SIZE];
+    int numTraps, numVamps;
+
+    // Dracula's view: every location is known
+    GameView gv = newGameView("GGE.... SGE.... HGE.... MGE.... DST.V.. "
+                              "GGE.... SGE.... HGE.... MGE.... DZUT... "
+                              "GGE.... SGE.... HGE.... MGE.... DHIT... "
+                              "GGE.... SGE.... HGE.... MGE.... DD2.... "
+                              "GSTV... SGE.... HGE.... MGE.... DTPT...", messages);
+    getHistory(gv, PLAYER_DRACULA, trail);
+    assert(trail[0] == TELEPORT && trail[1] == DOUBLE_BACK_2 && trail[2] == HIDE);
+    getLocationHistory(gv, PLAYER_DRACULA, trail);
+    assert(trail[0] == CASTLE_DRACULA && trail[1] == ZURICH && trail[2] == ZURICH);
+    assert(trail[3] == ZURICH && trail[4] == STRASBOURG && trail[5] == UNKNOWN_LOCATION);
+    getMinions(gv, ZURICH, &numTraps, &numVamps);
+    assert(numTraps == 2 && numVamps == 0);
+    getMinions(gv, STRASBOURG, &numTraps, &numVamps);
+    assert(numTraps == 0 && numVamps == 0);     // killed by Lord Godalming
+    getMinions(gv, CASTLE_DRACULA, &numTraps, &numVamps);
+    assert(numTraps == 1 && numVamps == 0);
+    disposeGameView(gv);
+
+    // A hunter's view: minions in unknown cities are not counted
+    gv = newGameView("GGE.... SGE.... HGE.... MGE.... DST.V.. "
+                     "GGE.... SGE.... HGE.... MGE.... DC?T... "
+                     "GGE.... SGE.... HGE.... MGE.... DD1T...", messages);
+    getLocationHistory(gv, PLAYER_DRACULA, trail);
+    assert(trail[0] == CITY_UNKNOWN && trail[1] == CITY_UNKNOWN && trail[2] == STRASBOURG);
+    getMinions(gv, STRASBOURG, &numTraps, &numVamps);
+    assert(numTraps == 0 && numVamps == 1);
+    getLocationHistory(gv, PLAYER_LORD_GODALMING, trail);
+    assert(trail[0] == GENEVA && trail[3] == UNKNOWN_LOCATION);
+    disposeGameView(gv);
+
+    printf("passed\n");
+}
+
+static void testGameState(void) {
+    printf("Test for the compact game state\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000];
+
+    assert(sizeof(GameState) <= 64);
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int n;
+    for(n = 0; n <= total; n++) {
+        GameView gv = newGameView(firstPlays(plays, n), messages);
+        GameState state;
+        initGameState(&state);
+        applyPlaysToState(&state, plays);
+
+        assert(stateRound(&state) == getRound(gv));
+        assert(stateCurrentPlayer(&state) == getCurrentPlayer(gv));
+        assert(stateScore(&state) == getScore(gv));
+
+        PlayerID p;
+        for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+            assert(stateHealth(&state, p) == getHealth(gv, p));
+            assert(stateLocation(&state, p) == getLocation(gv, p));
+        }
+
+        LocationID trail[TRAIL_SIZE], expected[TRAIL_SIZE];
+        stateDraculaTrail(&state, trail);
+        getHistory(gv, PLAYER_DRACULA, expected);
+        assert(memcmp(trail, expected, sizeof(trail)) == 0);
+        stateDraculaLocations(&state, trail);
+        getLocationHistory(gv, PLAYER_DRACULA, expected);
+        assert(memcmp(trail, expected, sizeof(trail)) == 0);
+
+        LocationID where;
+        for(where = MIN_MAP_LOCATION; where <= MAX_MAP_LOCATION; where++) {
+            int traps, vamps, expectedTraps, expectedVamps;
+            stateMinions(&state, where, &traps, &vamps);
+            getMinions(gv, where, &expectedTraps, &expectedVamps);
+            assert(traps == expectedTraps && vamps == expectedVamps);
+        }
+
+        disposeGameView(gv);
+    }
+
+    // a copy carries on by itself
+    GameState state, copy;
+    initGameState(&state);
+    applyPlaysToState(&state, firstPlays(plays, 9));
+    copy = state;
+    applyPlayToState(&copy, "DCDT...");
+    assert(stateLocation(&copy, PLAYER_DRACULA) == CASTLE_DRACULA);
+    assert(stateLocation(&state, PLAYER_DRACULA) == MADRID);
+    assert(stateHealth(&copy, PLAYER_DRACULA) == stateHealth(&state, PLAYER_DRACULA) + LIFE_GAIN_CASTLE_DRACULA);
+
+    printf("passed\n");
+}
+
+static void testCloneGameView(void) {
+    printf("Test for cloning a GameView\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000], later[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int start;
+    for(start = 0; start < total; start += 11) {
+        int next = start + 13 > total ? total : start + 13;
+        int length = strlen(firstPlays(plays, start));
+        GameView now = newGameView(plays, messages);
+        GameView ahead = newGameView(firstPlays(later, next), messages);
+
+        // the clone moves on, the original stays where it was
+        GameView original = newGameView(firstPlays(plays, start), messages);
+        GameView clone = cloneGameView(original);
+        applyPlays(clone, later + length);
+        assertSameGameView(clone, ahead);
+        assertSameGameView(original, now);
+
+        // a clone of a clone, outliving the views it came from
+        GameView second = cloneGameView(clone);
+        applyPlays(original, later + length);
+        disposeGameView(clone);
+        assertSameGameView(original, ahead);
+        disposeGameView(original);
+        assertSameGameView(second, ahead);
+
+        // clones trying different plays from the same view, one after
+        // another and side by side: each sees only its own
+        PlayerID player = start % NUM_PLAYERS;
+        if(start >= NUM_PLAYERS && start < total && player != PLAYER_DRACULA) {
+            char next[PLAY_LENGTH], rest[PLAY_LENGTH], restPlays[4000 + PLAY_LENGTH];
+            strncpy(next, wholeGame + start * PLAY_LENGTH, PLAY_LENGTH - 1);
+            next[PLAY_LENGTH - 1] = '\0';
+            sprintf(rest, "%c%s....", next[0], idToAbbrev(getLocation(now, player)));
+            sprintf(restPlays, "%s %s", firstPlays(plays, start), rest);
+            GameView moved = newGameView(firstPlays(later, start + 1), messages);
+            GameView rested = newGameView(restPlays, messages);
+            GameView from = newGameView(firstPlays(plays, start), messages);
+
+            GameView first = cloneGameView(from);
+            applyPlays(first, next);
+            assertSameGameView(first, moved);
+            disposeGameView(first);
+
+            GameView resting = cloneGameView(from);
+            applyPlays(resting, rest);
+            GameView moving = cloneGameView(from);
+            applyPlays(moving, next);
+            assertSameGameView(resting, rested);
+            assertSameGameView(moving, moved);
+            assertSameGameView(from, now);
+
+            // and the next player's play on a clone of one of them
+            char following[PLAY_LENGTH], furtherPlays[4000 + 2 * PLAY_LENGTH];
+            sprintf(following, "%c%s....", "GSHMD"[player + 1],
+                    idToAbbrev(getLocation(now, player + 1)));
+            sprintf(furtherPlays, "%s %s", restPlays, following);
+            GameView further = cloneGameView(resting);
+            applyPlays(further, following);
+            disposeGameView(resting);
+            disposeGameView(moving);
+            resting = cloneGameView(from);
+            applyPlays(resting, rest);
+            assertSameGameView(resting, rested);
+            assertSameGameView(from, now);
+            GameView furtherOn = newGameView(furtherPlays, messages);
+            assertSameGameView(further, furtherOn);
+
+            disposeGameView(furtherOn);
+            disposeGameView(further);
+            disposeGameView(resting);
+            disposeGameView(from);
+            disposeGameView(moved);
+            disposeGameView(rested);
+        }
+
+        disposeGameView(second);
+        disposeGameView(now);
+        disposeGameView(ahead);
+    }
+
+    printf("passed\n");
+}
+
+static void testSnapshots(void) {
+    printf("Test for snapshots of a GameView\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    static Snapshot snapshot, again;
+    char plays[4000];
+
+    // store a checkpoint for every round of the game
+    FILE *f = tmpfile();
+    assert(f != NULL);
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int numRounds = total / NUM_PLAYERS + 1;
+    GameView gv = newGameView("", messages);
+    int round;
+    for(round = 0; round < numRounds; round++) {
+        if(round > 0) {
+            int start = strlen(firstPlays(plays, (round - 1) * NUM_PLAYERS));
+            applyPlays(gv, firstPlays(plays, round * NUM_PLAYERS) + start);
+        }
+        takeSnapshot(gv, &snapshot);
+        assert(fwrite(&snapshot, sizeof(Snapshot), 1, f) == 1);
+    }
+    disposeGameView(gv);
+
+    // jump to them out of order, and carry on from each to the end
+    GameView whole = newGameView(firstPlays(plays, total), messages);
+    int i;
+    for(i = 0; i < numRounds; i++) {
+        round = (i * 7) % numRounds;
+        assert(fseek(f, (long) round * sizeof(Snapshot), SEEK_SET) == 0);
+        assert(fread(&snapshot, sizeof(Snapshot), 1, f) == 1);
+
+        GameView restored = restoreGameView(&snapshot);
+        assert(restored != NULL);
+        GameView parsed = newGameView(firstPlays(plays, round * NUM_PLAYERS), messages);
+        assertSameGameView(restored, parsed);
+
+        takeSnapshot(parsed, &again);
+        assert(memcmp(&snapshot, &again, sizeof(Snapshot)) == 0);
+
+        applyPlays(restored, wholeGame + strlen(plays));
+        assertSameGameView(restored, whole);
+
+        disposeGameView(restored);
+        disposeGameView(parsed);
+    }
+    disposeGameView(whole);
+    fclose(f);
+
+    // not a snapshot of this version
+    snapshot.version = SNAPSHOT_VERSION + 1;
+    assert(restoreGameView(&snapshot) == NULL);
+
+    // nor one with any field out of range, or not agreeing with the rest
+    static Snapshot good;
+    gv = newGameView(firstPlays(plays, total - 3), messages);
+    takeSnapshot(gv, &good);
+    disposeGameView(gv);
+    int how;
+    for(how = 0; ; how++) {
+        snapshot = good;
+        if(!corruptSnapshot(&snapshot, how)) break;
+        assert(restoreGameView(&snapshot) == NULL);
+    }
+    GameView restored = restoreGameView(&good);
+    assert(restored != NULL);
+    disposeGameView(restored);
+
+    printf("passed\n");
+}
+
+static void testWholeHistory(void) {
+    printf("Test for the whole history of each player\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int n;
+    for(n = 0; n <= total; n += 3) {
+        GameView gv = newGameView(firstPlays(plays, n), messages);
+
+        PlayerID p;
+        for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+            int numMoves, numLocations, i;
+            const LocationID *moves = getMoves(gv, p, &numMoves);
+            const LocationID *locations = getLocations(gv, p, &numLocations);
+            assert(numMoves == (n - p + NUM_PLAYERS - 1) / NUM_PLAYERS);
+            assert(numLocations == numMoves);
+            assert(getMoves(gv, p, &numMoves) == moves);     // the view's own array
+
+            // every move is there, in the round it was made
+            Round r;
+            for(r = 0; r < numMoves; r++) {
+                assert(moves[r] == moveToID(plays + (r * NUM_PLAYERS + p) * PLAY_LENGTH + 1));
+                assert(getMoveInRound(gv, p, r) == &moves[r]);
+                assert(getLocationInRound(gv, p, r) == &locations[r]);
+            }
+            assert(getMoveInRound(gv, p, numMoves) == NULL);
+            assert(getLocationInRound(gv, p, numMoves) == NULL);
+
+            // and the end of it is the trail
+            LocationID trail[TRAIL_SIZE];
+            getHistory(gv, p, trail);
+            for(i = 0; i < TRAIL_SIZE && i < numMoves; i++) assert(trail[i] == moves[numMoves - 1 - i]);
+            getLocationHistory(gv, p, trail);
+            for(i = 0; i < TRAIL_SIZE && i < numMoves; i++) assert(trail[i] == locations[numMoves - 1 - i]);
+        }
+
+        disposeGameView(gv);
+    }
+
+    printf("passed\n");
+}
+
+static void testEvents(void) {
+    printf("Test for the event log\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    static Event expected[GAME_START_SCORE * NUM_PLAYERS * 5];
+    char plays[4000];
+
+    // work out the events play by play from the action chars
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int numExpected = 0, n, j;
+    for(n = 1; n <= total; n++) {
+        char *play = firstPlays(plays, n) + (n - 1) * PLAY_LENGTH;
+        GameView gv = newGameView(plays, messages);
+        PlayerID player = (n - 1) % NUM_PLAYERS;
+        Round round = (n - 1) / NUM_PLAYERS;
+
+        int types[5], numTypes = 0;
+        LocationID where = getLocationInRound(gv, player, round)[0];
+        LocationID left = round >= TRAIL_SIZE ? getLocationInRound(gv, player, round - TRAIL_SIZE)[0] : NOWHERE;
+        if(player != PLAYER_DRACULA) {
+            for(j = 3; j < PLAY_LENGTH - 1 && play[j] != '.'; j++) {
+                types[numTypes++] = play[j] == 'T' ? EVENT_TRAP : play[j] == 'V' ? EVENT_VAMPIRE_KILLED : EVENT_DRACULA;
+            }
+            if(getHealth(gv, player) == 0) types[numTypes++] = EVENT_HOSPITAL;
+        } else {
+            if(play[3] == 'T') types[numTypes++] = EVENT_TRAP_PLACED;
+            if(play[4] == 'V') types[numTypes++] = EVENT_VAMPIRE_PLACED;
+            if(play[5] == 'M') types[numTypes++] = EVENT_TRAP_MALFUNCTION;
+            if(play[5] == 'V') types[numTypes++] = EVENT_VAMPIRE_MATURED;
+        }
+
+        for(j = 0; j < numTypes; j++) {
+            Event *e = &expected[numExpected++];
+            e->round = round;
+            e->player = player;
+            e->type = types[j];
+            e->location = types[j] == EVENT_TRAP_MALFUNCTION || types[j] == EVENT_VAMPIRE_MATURED ? left : where;
+        }
+
+        // which the view has logged
+        int numEvents;
+        const Event *events = getEvents(gv, &numEvents);
+        assert(numEvents == numExpected);
+        assert(numEvents == 0 || memcmp(events, expected, numEvents * sizeof(Event)) == 0);
+
+        disposeGameView(gv);
+    }
+
+    // and indexed by type
+    GameView gv = newGameView(firstPlays(plays, total), messages);
+    int type, seen[NUM_EVENT_TYPES] = {0};
+    for(j = 0; j < numExpected; j++) {
+        const Event *e = getEventOfType(gv, expected[j].type, seen[expected[j].type]++);
+        assert(e != NULL && memcmp(e, &expected[j], sizeof(Event)) == 0);
+    }
+    for(type = 0; type < NUM_EVENT_TYPES; type++) {
+        assert(seen[type] > 0);     // the game has every kind
+        assert(numEventsOfType(gv, type) == seen[type]);
+        assert(getEventOfType(gv, type, seen[type]) == NULL);
+
+        Round round;
+        for(round = 0; round <= total / NUM_PLAYERS + 1; round++) {
+            const Event *last = NULL;
+            for(j = 0; j < numExpected; j++) {
+                if(expected[j].type == type && expected[j].round < round) last = &expected[j];
+            }
+
+            const Event *e = lastEventBefore(gv, type, round);
+            assert((e == NULL) == (last == NULL));
+            assert(e == NULL || memcmp(e, last, sizeof(Event)) == 0);
+        }
+    }
+    disposeGameView(gv);
+
+    printf("passed\n");
+}
+
+// The timeline of the whole game against views of each part of it
+static void testTimeline(void) {
+    printf("Test for the score and health timeline\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    GameView whole = newGameView(wholeGame, messages);
+    GameView clone = cloneGameView(whole);
+
+    int n;
+    PlayerID p;
+    for(n = 0; n <= total; n++) {
+        GameView gv = newGameView(firstPlays(plays, n), messages);
+        assert(getScoreAfter(whole, n) == getScore(gv));
+        for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+            assert(getHealthAfter(whole, p, n) == getHealth(gv, p));
+        }
+
+        // and a view of part of the game has the same timeline so far
+        assert(getScoreAfter(gv, n) == getScoreAfter(whole, n));
+        assert(n == 0 || getHealthAfter(gv, (n - 1) % NUM_PLAYERS, n - 1) ==
+                         getHealthAfter(whole, (n - 1) % NUM_PLAYERS, n - 1));
+        disposeGameView(gv);
+    }
+
+    // a clone keeps it once the original is gone
+    disposeGameView(whole);
+    assert(getScoreAfter(clone, total) == getScore(clone));
+    assert(getHealthAfter(clone, PLAYER_DRACULA, 0) == GAME_START_BLOOD_POINTS);
+    disposeGameView(clone);
+
+    printf("passed\n");
+}
+
+// Messages are read from the caller's array, and only when asked for
+static void testMessages(void) {
+    printf("Test for messages\n");
+    static PlayerMessage messages[GAME_START_SCORE * NUM_PLAYERS];
+    char plays[4000];
+
+    int total = (strlen(wholeGame) + 1) / PLAY_LENGTH;
+    int n;
+    for(n = 0; n < total; n++) sprintf(messages[n], "play %d", n);
+
+    GameView gv = newGameView(firstPlays(plays, total - NUM_PLAYERS), messages);
+    GameView quiet = newGameView(plays, NULL);
+    assertSameGameView(gv, quiet);
+
+    for(n = 0; n < total - NUM_PLAYERS; n++) {
+        assert(getMessage(gv, n) == messages[n]);
+        assert(strcmp(getMessage(quiet, n), "") == 0);
+    }
+
+    // changed after the view was made
+    strcpy(messages[0], "changed");
+    assert(strcmp(getMessage(gv, 0), "changed") == 0);
+
+    // clones share them, but plays applied later come without any
+    GameView clone = cloneGameView(gv);
+    applyPlays(clone, wholeGame + strlen(plays));
+    assert(getMessage(clone, 1) == messages[1]);
+    for(n = total - NUM_PLAYERS; n < total; n++) {
+        assert(strcmp(getMessage(clone, n), "") == 0);
+    }
+
+    disposeGameView(gv);
+    disposeGameView(quiet);
+    disposeGameView(clone);
+
+    printf("passed\n");
+}
+
+static void assertSameGameView(GameView a, GameView b) {
+    assert(getRound(a) == getRound(b));
+    assert(getCurrentPlayer(a) == getCurrentPlayer(b));
+    assert(getScore(a) == getScore(b));
+
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        assert(getHealth(a, p) == getHealth(b, p));
+        assert(getLocation(a, p) == getLocation(b, p));
+
+        LocationID trailA[TRAIL_SIZE], trailB[TRAIL_SIZE];
+        getHistory(a, p, trailA);
+        getHistory(b, p, trailB);
+        assert(memcmp(trailA, trailB, sizeof(trailA)) == 0);
+    }
+
+    int numA, numB;
+    const Event *eventsA = getEvents(a, &numA);
+    const Event *eventsB = getEvents(b, &numB);
+    assert(numA == numB);
+    assert(numA == 0 || memcmp(eventsA, eventsB, numA * sizeof(Event)) == 0);
+
+    int n, plays = getRound(a) * NUM_PLAYERS + getCurrentPlayer(a);
+    for(n = 0; n <= plays; n++) {
+        assert(getScoreAfter(a, n) == getScoreAfter(b, n));
+        for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+            assert(getHealthAfter(a, p, n) == getHealthAfter(b, p, n));
+        }
+    }
+}
+
+// Spoils a snapshot in one of a number of ways; FALSE once out of ways
+static int corruptSnapshot(Snapshot *snapshot, int how) {
+    GameState *state = &snapshot->state;
+    int turn = state->turn;
+    int numDracMoves = snapshot->numMoves[PLAYER_DRACULA];
+
+    switch(how) {
+    case 0:  snapshot->magic ^= 1; break;
+    case 1:  snapshot->numMoves[PLAYER_LORD_GODALMING] = GAME_START_SCORE + 1; break;
+    case 2:  snapshot->numMoves[PLAYER_DR_SEWARD] = -1; break;
+    case 3:  snapshot->numMoves[PLAYER_DRACULA]++; break;
+    case 4:  snapshot->moves[PLAYER_VAN_HELSING][0] = MAX_MAP_LOCATION + 1; break;
+    case 5:  snapshot->moves[PLAYER_MINA_HARKER][3] = NOWHERE; break;
+    case 6:  snapshot->moves[PLAYER_DRACULA][numDracMoves - 1] = CITY_UNKNOWN; break;
+    case 7:  snapshot->dracLocations[0] = HIDE; break;
+    case 8:  snapshot->dracLocations[numDracMoves - 2] = NOWHERE; break;
+    case 9:  snapshot->actions[PLAYER_LORD_GODALMING][0] |= ACTION_HOSPITAL << 1; break;
+    case 10: snapshot->actions[PLAYER_DRACULA][1] |= ACTION_HOSPITAL; break;
+    case 11: snapshot->timeline[5].hunterHealth |= (1 << HUNTER_HEALTH_BITS) - 1; break;
+    case 12: snapshot->timeline[7].score = GAME_START_SCORE + 1; break;
+    case 13: snapshot->timeline[turn - 1].score--; break;
+    case 14: snapshot->timeline[turn - 1].dracHealth++; break;
+    case 15: state->turn = 30000; break;
+    case 16: state->turn++; break;
+    case 17: state->score = GAME_START_SCORE + 1; break;
+    case 18: state->health[PLAYER_DR_SEWARD] = GAME_START_HUNTER_LIFE_POINTS + 1; break;
+    case 19: state->location[PLAYER_VAN_HELSING] = MAX_MAP_LOCATION + 1; break;
+    case 20: state->trailMoves |= (1 << TRAIL_BITS) - 1; break;
+    case 21: state->trailLocations ^= 1ULL << (TRAIL_BITS * TRAIL_SIZE); break;
+    case 22: state->killed |= 1 << PLAYER_DRACULA; break;
+    case 23: state->traps = 0xff; break;
+    default: return FALSE;
+    }
+    return TRUE;
+}
+
+// Copies the first numPlays plays of wholeGame into plays
+static char *firstPlays(char *plays, int numPlays) {
+    int length = numPlays == 0 ? 0 : numPlays * PLAY_LENGTH - 1;
+    assert(length <= strlen(wholeGame));
+
+    strncpy(plays, wholeGame, length);
+    plays[length] = '\0';
+    return plays;
+}
@@ -0,0 +1,107 @@
+// testHunterView.c ... test the HunterView ADT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "HunterView.h"
+#include "GameView.h"
+
+static void testBidirectionalPaths(void);
+static void checkPath(GameView gv, PlayerID player, LocationID *path, int length, int rail);
+static void testGiveMeTheState(void);
+
+int main(int argc, char *argv[]) {
+    testBidirectionalPaths();
+    testGiveMeTheState();
+
+    return EXIT_SUCCESS;
+}
+
+// The bidirectional search must agree with the one-way search
+static void testBidirectionalPaths(void) {
+    printf("Test for bidirectional shortest paths\n");
+
+    char *plays[] = {
+        "",
+        "GGE.... SGE.... HGE.... MGE.... DC?....",
+        "GGE.... SGE.... HGE.... MGE.... DC?.... GGE.... SGE.... HGE.... MGE.... DC?....",
+        "GGE.... SGE.... HGE.... MGE.... DC?.... GGE.... SGE.... HGE.... MGE.... DC?.... "
+        "GGE.... SGE.... HGE.... MGE.... DC?....",
+    };
+
+    int i;
+    for(i = 0; i < 4; i++) {
+        PlayerMessage messages[] = {""};
+        HunterView hv = newHunterView(plays[i], messages);
+        GameView gv = newGameView(plays[i], messages);
+        assert(giveMeTheRound(hv) == i);
+
+        PlayerID player;
+        LocationID start, end;
+        for(player = PLAYER_LORD_GODALMING; player <= PLAYER_DRACULA; player++) {
+            for(start = MIN_MAP_LOCATION; start <= MAX_MAP_LOCATION; start += 3) {
+                for(end = MIN_MAP_LOCATION; end <= MAX_MAP_LOCATION; end++) {
+                    int rail = (start + end) % 2;
+                    int oneWay = 0, twoWay = 0;
+                    LocationID *p1 = shortestPath(hv, &oneWay, player, start, end, 1, rail, 1);
+                    LocationID *p2 = shortestPathBidir(hv, &twoWay, player, start, end, 1, rail, 1);
+
+                    assert(oneWay == twoWay);
+                    checkPath(gv, player, p2, twoWay, rail);
+
+                    free(p1);
+                    free(p2);
+                }
+            }
+        }
+
+        disposeHunterView(hv);
+        disposeGameView(gv);
+    }
+
+    printf("passed\n");
+}
+
+// Every step of the path must be a legal move in the round it is made
+static void checkPath(GameView gv, PlayerID player, LocationID *path, int length, int rail) {
+    Round round = getRound(gv);
+
+    int i;
+    for(i = 0; i + 1 < length; i++) {
+        int reachable[NUM_MAP_LOCATIONS];
+        reachableFrom(gv, reachable, path[i], player, round + i, 1, rail, 1);
+        assert(reachable[path[i+1]]);
+        assert(path[i+1] != path[i]);
+    }
+}
+
+// The state in one call against the accessors, with Dracula's moves hidden
+static void testGiveMeTheState(void) {
+    printf("Test for giveMeTheState\n");
+    HunterView hv = newHunterView("GGE.... SGE.... HGE.... MGE.... DC?.V.. "
+                                  "GST.... SGE.... HGE.... MGE.... DS?.... "
+                                  "GGE.... SMR....", NULL);
+
+    ViewState state;
+    giveMeTheState(hv, &state);
+    assert(state.round == giveMeTheRound(hv));
+    assert(state.currentPlayer == whoAmI(hv));
+    assert(state.score == giveMeTheScore(hv));
+
+    PlayerID p;
+    int i;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        assert(state.health[p] == howHealthyIs(hv, p));
+        assert(state.location[p] == whereIs(hv, p));
+
+        LocationID trail[TRAIL_SIZE];
+        giveMeTheTrail(hv, p, trail);
+        for(i = 0; i < TRAIL_SIZE; i++) assert(state.trail[p][i] == trail[i]);
+    }
+    assert(state.location[PLAYER_DRACULA] == SEA_UNKNOWN);
+    assert(state.trail[PLAYER_DRACULA][1] == CITY_UNKNOWN);
+
+    disposeHunterView(hv);
+    printf("passed\n");
+}
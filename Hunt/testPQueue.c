@@ -0,0 +1,202 @@
+// testPQueue.c ... test the Heap and BucketQueue priority queues
+//
+// Runs each queue through random searches alongside a plain array of
+// the costs queued, checking every item taken out is one of the cheapest
+// left, then the cases a search relies on: decrease-key, resetting
+// between searches and queues laid out in caller storage.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include "Globals.h"
+#include "PQueue.h"
+#include "Random.h"
+
+#define CAPACITY 71
+#define MAX_STEP 3
+#define NUM_SEARCHES 200
+#define NOT_QUEUED INT_MIN           // costs may be negative
+
+static void testHeap(void);
+static void testBucketQueue(void);
+static void testSmallQueues(void);
+static int cheapest(int queued[]);
+
+int main(int argc, char *argv[]) {
+    testHeap();
+    testBucketQueue();
+    testSmallQueues();
+
+    return EXIT_SUCCESS;
+}
+
+// Any costs, entered and lowered in any order
+static void testHeap(void) {
+    printf("Test for Heap\n");
+    Random random;
+    seedRandom(&random, 1);
+
+    int queued[CAPACITY];
+    Heap h = newHeap(CAPACITY);
+
+    int s, i;
+    for(s = 0; s < NUM_SEARCHES; s++) {
+        for(i = 0; i < CAPACITY; i++) queued[i] = NOT_QUEUED;
+
+        // a random mix of entering, lowering and taking out
+        int steps = randomIndex(&random, 4 * CAPACITY);
+        for(i = 0; i < steps; i++) {
+            int item = randomIndex(&random, CAPACITY);
+            if(randomIndex(&random, 3) > 0) {
+                int cost = randomIndex(&random, 1000) - 500;
+                if(queued[item] != NOT_QUEUED && cost > queued[item]) cost = queued[item];
+
+                enterHeap(h, item, cost);
+                queued[item] = cost;
+            } else if(!emptyHeap(h)) {
+                int cost;
+                item = leaveHeap(h, &cost);
+                assert(queued[item] == cost && cost == cheapest(queued));
+                queued[item] = NOT_QUEUED;
+            }
+            assert(inHeap(h, item) == (queued[item] != NOT_QUEUED));
+        }
+
+        // half the searches run to the end, half are cut short
+        if(s % 2 == 0) {
+            int last = -500;
+            while(!emptyHeap(h)) {
+                int cost;
+                int item = leaveHeap(h, &cost);
+                assert(queued[item] == cost && cost == cheapest(queued) && cost >= last);
+                queued[item] = NOT_QUEUED;
+                last = cost;
+            }
+        }
+        resetHeap(h);
+        assert(emptyHeap(h));
+        for(i = 0; i < CAPACITY; i++) assert(!inHeap(h, i));
+    }
+
+    disposeHeap(h);
+    printf("passed\n");
+}
+
+// Costs that never drop below the last taken out, nor go more than
+// MAX_STEP above it, as in Dijkstra
+static void testBucketQueue(void) {
+    printf("Test for BucketQueue\n");
+    Random random;
+    seedRandom(&random, 2);
+
+    int queued[CAPACITY];
+    BucketQueue b = newBucketQueue(CAPACITY, MAX_STEP);
+
+    int s, i;
+    for(s = 0; s < NUM_SEARCHES; s++) {
+        for(i = 0; i < CAPACITY; i++) queued[i] = NOT_QUEUED;
+
+        int current = 0;
+        int steps = randomIndex(&random, 4 * CAPACITY);
+        for(i = 0; i < steps; i++) {
+            int item = randomIndex(&random, CAPACITY);
+            if(randomIndex(&random, 3) > 0) {
+                int cost = current + randomIndex(&random, MAX_STEP + 1);
+                if(queued[item] != NOT_QUEUED && cost > queued[item]) cost = queued[item];
+
+                enterBucketQueue(b, item, cost);
+                queued[item] = cost;
+            } else if(!emptyBucketQueue(b)) {
+                int cost;
+                item = leaveBucketQueue(b, &cost);
+                assert(queued[item] == cost && cost == cheapest(queued) && cost >= current);
+                queued[item] = NOT_QUEUED;
+                current = cost;
+            }
+            assert(inBucketQueue(b, item) == (queued[item] != NOT_QUEUED));
+        }
+
+        if(s % 2 == 0) {
+            while(!emptyBucketQueue(b)) {
+                int cost;
+                int item = leaveBucketQueue(b, &cost);
+                assert(queued[item] == cost && cost == cheapest(queued) && cost >= current);
+                queued[item] = NOT_QUEUED;
+                current = cost;
+            }
+        }
+
+        // the next search starts again from cost 0
+        resetBucketQueue(b);
+        assert(emptyBucketQueue(b));
+        for(i = 0; i < CAPACITY; i++) assert(!inBucketQueue(b, i));
+    }
+
+    disposeBucketQueue(b);
+    printf("passed\n");
+}
+
+// Lowering an item's cost, ties, a cost of exactly MAX_STEP more and
+// queues in caller storage, which dispose leaves alone
+static void testSmallQueues(void) {
+    printf("Test for decrease-key and queues in caller storage\n");
+    int cost;
+
+    int heapStorage[HEAP_WORDS(4)];
+    Heap h = heapIn(heapStorage, 4);
+    assert(emptyHeap(h));
+    enterHeap(h, 0, 10);
+    enterHeap(h, 1, 20);
+    enterHeap(h, 2, 30);
+    enterHeap(h, 2, 5);
+    enterHeap(h, 3, 5);
+    assert(inHeap(h, 2) && inHeap(h, 3));
+
+    int first = leaveHeap(h, &cost);
+    assert(cost == 5 && (first == 2 || first == 3));
+    assert(leaveHeap(h, &cost) == 5 - first && cost == 5);
+    assert(leaveHeap(h, NULL) == 0 && !inHeap(h, 0));
+    assert(leaveHeap(h, &cost) == 1 && cost == 20);
+    assert(emptyHeap(h));
+    disposeHeap(h);
+    assert(heapIn(heapStorage, 4) == h && emptyHeap(h));
+
+    int bucketStorage[BUCKET_QUEUE_WORDS(4, MAX_STEP)];
+    BucketQueue b = bucketQueueIn(bucketStorage, 4, MAX_STEP);
+    assert(emptyBucketQueue(b));
+    enterBucketQueue(b, 0, MAX_STEP);
+    enterBucketQueue(b, 1, 2);
+    enterBucketQueue(b, 1, 0);
+    enterBucketQueue(b, 2, 1);
+    assert(leaveBucketQueue(b, &cost) == 1 && cost == 0);
+    assert(!inBucketQueue(b, 1));
+
+    // costs wrap round the buckets as the search goes on
+    enterBucketQueue(b, 3, MAX_STEP);
+    enterBucketQueue(b, 1, 1);
+    assert(leaveBucketQueue(b, &cost) != 3 && cost == 1);
+    assert(leaveBucketQueue(b, &cost) != 3 && cost == 1);
+    enterBucketQueue(b, 2, 1 + MAX_STEP);
+    assert(leaveBucketQueue(b, &cost) != 2 && cost == MAX_STEP);
+    assert(leaveBucketQueue(b, &cost) != 2 && cost == MAX_STEP);
+    assert(leaveBucketQueue(b, NULL) == 2);
+    assert(emptyBucketQueue(b));
+    disposeBucketQueue(b);
+
+    printf("passed\n");
+}
+
+// The lowest cost queued, or NOT_QUEUED if none are
+static int cheapest(int queued[]) {
+    int lowest = NOT_QUEUED;
+
+    int i;
+    for(i = 0; i < CAPACITY; i++) {
+        if(queued[i] != NOT_QUEUED && (lowest == NOT_QUEUED || queued[i] < lowest)) {
+            lowest = queued[i];
+        }
+    }
+
+    return lowest;
+}
@@ -0,0 +1,199 @@
+// testThreads.c ... test using views from several threads at once
+//
+// Half the threads query one DracView that none of them changes (and
+// clone it and play on the clones); the other half build, update,
+// snapshot and batch parse views of their own. Every answer is checked
+// against the same question asked before any thread started. Build it
+// with "make tsan" to have ThreadSanitizer watch for races as well.
+// Usage: ./testThreads [log...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "Globals.h"
+#include "GameView.h"
+#include "DracView.h"
+#include "GameBatch.h"
+#include "LogReader.h"
+
+#define NUM_THREADS 8
+#define REPS 4                       // times each thread does its work
+
+static char *game;                   // the longest game that shows Dracula's moves
+static int numPlays;
+static DracView shared;              // never changed once the threads start
+
+// the shared view's answers, from before the threads started
+static int threatening[NUM_MAP_LOCATIONS][MAX_THREAT_ROUNDS + 1];
+static int pathLength[NUM_MAP_LOCATIONS];
+static GameState finalState;
+
+static void keepLongest(char *fileName);
+static void keepIfLongest(char *pastPlays, int length, void *arg);
+static void *queryShared(void *arg);
+static void *useOwnViews(void *arg);
+static char *firstPlays(int n);
+static void assertSameDracView(DracView a, DracView b);
+
+int main(int argc, char *argv[]) {
+    printf("Test for using views from several threads\n");
+
+    int i;
+    forEachLog(argc - 1, argv + 1, keepLongest);
+    assert(game != NULL);
+    numPlays = (strlen(game) + 1) / PLAY_LENGTH;
+
+    shared = newDracView(game, NULL);
+    LocationID where;
+    int rounds;
+    for(where = MIN_MAP_LOCATION; where <= MAX_MAP_LOCATION; where++) {
+        for(rounds = 0; rounds <= MAX_THREAT_ROUNDS; rounds++) {
+            threatening[where][rounds] = huntersThreatening(shared, where, rounds);
+        }
+        LocationID *path = shortestPath(shared, &pathLength[where],
+                                        whereIs(shared, PLAYER_DRACULA), where, TRUE, TRUE);
+        free(path);
+    }
+    initGameState(&finalState);
+    applyPlaysToState(&finalState, game);
+
+    pthread_t threads[NUM_THREADS];
+    for(i = 0; i < NUM_THREADS; i++) {
+        if(pthread_create(&threads[i], NULL, i % 2 == 0 ? queryShared : useOwnViews,
+                          (void *) (long) i) != 0) {
+            fprintf(stderr, "can't start thread %d\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for(i = 0; i < NUM_THREADS; i++) pthread_join(threads[i], NULL);
+
+    disposeDracView(shared);
+    free(game);
+    printf("passed\n");
+    return EXIT_SUCCESS;
+}
+
+// Keeps the longest pastPlays in a log that shows where Dracula went
+static void keepLongest(char *fileName) {
+    readLog(fileName, keepIfLongest, NULL);
+}
+
+static void keepIfLongest(char *pastPlays, int length, void *arg) {
+    if(strstr(pastPlays, "DC?") != NULL || strstr(pastPlays, "DS?") != NULL) return;
+    if(game != NULL && strlen(game) >= length) return;
+
+    free(game);
+    game = malloc(length + 1);
+    assert(game != NULL);
+    strcpy(game, pastPlays);
+}
+
+// Asks the shared view everything asked of it before, and plays on clones of it
+static void *queryShared(void *arg) {
+    int r;
+    for(r = 0; r < REPS; r++) {
+        LocationID where;
+        int rounds, length;
+        for(where = MIN_MAP_LOCATION; where <= MAX_MAP_LOCATION; where++) {
+            for(rounds = 0; rounds <= MAX_THREAT_ROUNDS; rounds++) {
+                assert(huntersThreatening(shared, where, rounds) == threatening[where][rounds]);
+            }
+            LocationID *path = shortestPath(shared, &length, whereIs(shared, PLAYER_DRACULA),
+                                            where, TRUE, TRUE);
+            assert(length == pathLength[where]);
+            free(path);
+        }
+
+        int numLocations;
+        LocationID *moves = whereCanIgo(shared, &numLocations, TRUE, TRUE);
+        assert(numLocations > 0);
+        free(moves);
+
+        int numMoves;
+        const LocationID *trail = giveMeTheWholeTrail(shared, PLAYER_DRACULA, &numMoves);
+        assert(numMoves == giveMeTheRound(shared));
+        assert(trail[numMoves - 1] == whereIs(shared, PLAYER_DRACULA));
+
+        // the clones share its history until they play (Dracula's last move again)
+        char play[PLAY_LENGTH];
+        strncpy(play, game + (numPlays - NUM_PLAYERS) * PLAY_LENGTH, PLAY_LENGTH - 1);
+        play[PLAY_LENGTH - 1] = '\0';
+
+        DracView clone = cloneDracView(shared);
+        assertSameDracView(clone, shared);
+        updateDracView(clone, play);
+        giveMeTheWholeTrail(clone, PLAYER_DRACULA, &length);
+        assert(length == numMoves + 1);
+        assert(giveMeTheWholeTrail(shared, PLAYER_DRACULA, &length) == trail && length == numMoves);
+        disposeDracView(clone);
+    }
+
+    return NULL;
+}
+
+// Builds views of its own from parts of the game and checks they catch up
+static void *useOwnViews(void *arg) {
+    int thread = (long) arg;
+    char *plays = NULL;
+
+    int r;
+    for(r = 0; r < REPS; r++) {
+        int n = (numPlays / NUM_PLAYERS * NUM_PLAYERS) * (thread + r) / (NUM_THREADS + REPS);
+        n = n / NUM_PLAYERS * NUM_PLAYERS;          // a Dracula view starts after Mina's play
+        free(plays);
+        plays = firstPlays(n);
+
+        DracView dv = newDracView(plays, NULL);
+        updateDracView(dv, game + strlen(plays));
+        assertSameDracView(dv, shared);
+
+        Snapshot *snapshot = malloc(sizeof(Snapshot));
+        assert(snapshot != NULL);
+        takeDracSnapshot(dv, snapshot);
+        DracView restored = restoreDracView(snapshot);
+        assertSameDracView(restored, shared);
+        free(snapshot);
+
+        disposeDracView(dv);
+        disposeDracView(restored);
+
+        // and a batch of its own, itself over threads
+        char *positions[] = {plays, game, plays, game};
+        GameState states[4];
+        parseBatch(positions, 4, states, 2);
+        assert(stateScore(&states[1]) == stateScore(&finalState));
+        assert(stateRound(&states[3]) == stateRound(&finalState));
+    }
+    free(plays);
+
+    return NULL;
+}
+
+// A copy of the first n plays of the game
+static char *firstPlays(int n) {
+    int length = n == 0 ? 0 : n * PLAY_LENGTH - 1;
+    char *plays = malloc(length + 1);
+    assert(plays != NULL);
+
+    strncpy(plays, game, length);
+    plays[length] = '\0';
+    return plays;
+}
+
+static void assertSameDracView(DracView a, DracView b) {
+    assert(giveMeTheRound(a) == giveMeTheRound(b));
+    assert(giveMeTheScore(a) == giveMeTheScore(b));
+
+    PlayerID p;
+    for(p = PLAYER_LORD_GODALMING; p <= PLAYER_DRACULA; p++) {
+        assert(howHealthyIs(a, p) == howHealthyIs(b, p));
+        assert(whereIs(a, p) == whereIs(b, p));
+
+        LocationID trailA[TRAIL_SIZE], trailB[TRAIL_SIZE];
+        giveMeTheTrail(a, p, trailA);
+        giveMeTheTrail(b, p, trailB);
+        assert(memcmp(trailA, trailB, sizeof(trailA)) == 0);
+    }
+}